@@ -157,6 +157,9 @@ int main(int argc, char *argv[])
       {
         "line-solver", { "--line-solver" },
         "Line solver: might output an incomplete solution if the grid is not line solvable", 0 },
+      {
+        "line-engine", { "--line-engine" },
+        "Line reduction engine of the reference solver: alternatives, automaton or auto (default)", 1 },
       {
         "timeout", { "--timeout" },
         "Timeout on grid solve, in seconds", 1 },
@@ -228,7 +231,25 @@ int main(int argc, char *argv[])
     if (validation_mode) { stream_out_validation_mode_header(std::cout, verbose_mode); }
 
     /* Solver */
-    const auto solver = args["line-solver"] ? picross::get_line_solver() : picross::get_ref_solver();
+    picross::SolverConfig solver_config;
+    if (args["line-engine"])
+    {
+        const std::string line_engine = args["line-engine"].as<std::string>();
+        if (line_engine == "alternatives")
+            solver_config.line_solver_engine = picross::LineSolverEngine::LINE_ALTERNATIVES;
+        else if (line_engine == "automaton")
+            solver_config.line_solver_engine = picross::LineSolverEngine::AUTOMATON;
+        else if (line_engine == "auto")
+            solver_config.line_solver_engine = picross::LineSolverEngine::AUTO;
+        else
+        {
+            std::cerr << usage_note.str();
+            std::cerr << std::endl;
+            std::cerr << "Invalid line engine: " << line_engine << std::endl;
+            exit(1);
+        }
+    }
+    const auto solver = args["line-solver"] ? picross::get_line_solver() : picross::get_ref_solver(solver_config);
 
 
     /***************************************************************************
@@ -16,11 +16,13 @@
 #include "picross_stats.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace picross {
@@ -86,6 +88,10 @@ public:
     // If the solver returns with status Status::NOT_LINE_SOLVABLE, the partially solved grid is passed to the
     // callback function solution_found, with the partial flag set to true
     //
+    // The solver is sequential by default. If it is configured with several threads (see SolverConfig) and no observer is
+    // set, the probing and the branch search run on several threads. The callback is then called from any of those threads,
+    // but never concurrently.
+    //
     using SolutionFound = std::function<bool(Solution&&)>;
     virtual Status solve(const InputGrid& input_grid, SolutionFound solution_found) const = 0;
 
@@ -111,6 +117,7 @@ public:
     //
     // If set, the solver will regularly call this function and abort its processing in case it returns true.
     // The solver will return the fully completed solutions it has already computed.
+    // As with the SolutionFound callback, the function can be called from any thread of the solver, but never concurrently.
     //
     using Abort = std::function<bool()>;
     virtual void set_abort_function(Abort abort) = 0;
@@ -119,10 +126,81 @@ public:
 std::ostream& operator<<(std::ostream& out, Solver::Status status);
 
 
+/*
+ * Heuristic used by the branch search to select the line on which to make a hypothesis
+ *
+ *   FEWEST_ALTERNATIVES    The uncompleted line with the fewest alternatives
+ *   NEXT_TO_COMPLETED      Among the edges of the grid and the lines next to a completed one, the line with the fewest alternatives
+ *   ACTIVITY               Among the lines with the fewest alternatives, the line most involved in the recent contradictions
+ */
+enum class BranchingHeuristic
+{
+    FEWEST_ALTERNATIVES,
+    NEXT_TO_COMPLETED,
+    ACTIVITY
+};
+
+/*
+ * Engine of the full reduction of the lines
+ *
+ *   LINE_ALTERNATIVES      Dynamic programming over the positions of the segments
+ *   AUTOMATON              Bit-parallel automaton compiled from the constraint of the line
+ *   AUTO                   The automaton on the lines where its state fits in one machine word, otherwise the dynamic programming
+ *
+ *   All the engines give the same reductions, therefore the same solutions. Only the solve time differs.
+ */
+enum class LineSolverEngine
+{
+    LINE_ALTERNATIVES,
+    AUTOMATON,
+    AUTO
+};
+
+/*
+ * Configuration of the reference grid solver
+ *
+ *   The default values are the ones of get_ref_solver(). Lines with up to min_nb_alternatives alternatives are fully reduced
+ *   by the first grid pass; that limit is then ramped up to max_nb_alternatives. The probing rounds, on the root grid, consider
+ *   the nb_lines_per_probing_round lines with the fewest alternatives (below max_nb_alternatives_probing_other), plus the edges
+ *   of the grid (below max_nb_alternatives_probing_edge). Cell probing only applies if probing is enabled.
+ *   The number of threads is at most MAX_NB_THREADS, and max_nb_alternatives at most MAX_NB_ALTERNATIVES.
+ *
+ *   Throughput for many small grids: nb_threads = 1 (the default). Latency for a few large grids: nb_threads = 0 (one per
+ *   hardware thread), in which case the callbacks of the solver may be called from any of its threads (see Solver::solve).
+ */
+struct SolverConfig
+{
+    static constexpr unsigned int MAX_NB_THREADS = 256u;
+    static constexpr std::uint64_t MAX_NB_ALTERNATIVES = std::uint64_t{1} << 62;
+
+    bool probing = true;
+    bool cell_probing = true;
+    bool line_cache = true;
+    bool backjumping = true;
+    BranchingHeuristic branching_heuristic = BranchingHeuristic::FEWEST_ALTERNATIVES;
+    LineSolverEngine line_solver_engine = LineSolverEngine::AUTO;
+    unsigned int nb_threads = 1u;                                   // One: sequential solver. Zero: one per hardware thread
+    unsigned int nb_lines_per_probing_round = 12u;
+    unsigned int nb_cells_per_probing_round = 16u;
+    std::uint64_t min_nb_alternatives = 1u << 10;
+    std::uint64_t max_nb_alternatives = 1u << 26;
+    std::uint64_t max_nb_alternatives_probing_edge = 1u << 12;
+    std::uint64_t max_nb_alternatives_probing_other = 1u << 8;
+};
+
+/*
+ * Check the validity of a SolverConfig. Return false and an error message if it is not valid.
+ */
+std::pair<bool, std::string> check_solver_config(const SolverConfig& config);
+
+
 /*
  * Factory for the reference grid solver
+ *
+ * NB: Will throw std::invalid_argument on an invalid SolverConfig (i.e. not passing check_solver_config)
  */
 std::unique_ptr<Solver> get_ref_solver();
+std::unique_ptr<Solver> get_ref_solver(const SolverConfig& config);
 
 
 /*
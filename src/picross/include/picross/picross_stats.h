@@ -9,6 +9,7 @@
  ******************************************************************************/
 #pragma once
 
+#include <cstdint>
 #include <ostream>
 #include <vector>
 
@@ -25,16 +26,16 @@ struct GridStats
     unsigned int max_k = 0u;                                            // max nb of segments in a constraint (grid property)
     unsigned int max_branching_depth = 0u;                              // max branching depth of the solver (not of the solutions)
     unsigned int nb_branching_calls = 0u;
-    unsigned int total_nb_branching_alternatives = 0u;
+    std::uint64_t total_nb_branching_alternatives = 0u;
     unsigned int nb_probing_calls = 0u;
-    unsigned int total_nb_probing_alternatives = 0u;
-    unsigned int max_initial_nb_alternatives = 0u;
-    unsigned int max_nb_alternatives_partial = 0u;
-    unsigned int max_nb_alternatives_partial_w_change = 0u;
-    unsigned int max_nb_alternatives_linear = 0u;
-    unsigned int max_nb_alternatives_linear_w_change = 0u;
-    unsigned int max_nb_alternatives_full = 0u;
-    unsigned int max_nb_alternatives_full_w_change = 0u;
+    std::uint64_t total_nb_probing_alternatives = 0u;
+    std::uint64_t max_initial_nb_alternatives = 0u;
+    std::uint64_t max_nb_alternatives_partial = 0u;
+    std::uint64_t max_nb_alternatives_partial_w_change = 0u;
+    std::uint64_t max_nb_alternatives_linear = 0u;
+    std::uint64_t max_nb_alternatives_linear_w_change = 0u;
+    std::uint64_t max_nb_alternatives_full = 0u;
+    std::uint64_t max_nb_alternatives_full_w_change = 0u;
     unsigned int nb_reduce_list_of_lines_calls = 0u;
     unsigned int max_reduce_list_size = 0u;
     unsigned int total_lines_reduced = 0u;
@@ -45,7 +46,19 @@ struct GridStats
     unsigned int nb_single_line_linear_reduction_w_change = 0u;
     unsigned int nb_single_line_full_reduction = 0u;
     unsigned int nb_single_line_full_reduction_w_change = 0u;
-    std::vector<unsigned int> max_nb_alternatives_by_branching_depth;   // vector with max_branching_depth elements
+    unsigned int nb_reduction_cache_hits = 0u;
+    unsigned int nb_reduction_cache_misses = 0u;
+    unsigned int nb_stolen_branching_alternatives = 0u;                 // by the idle threads of the parallel branch search
+    unsigned int nb_cell_probing_calls = 0u;
+    unsigned int nb_implications = 0u;                                  // between two tiles, found by the cell probing
+    unsigned int nb_implied_tiles = 0u;                                 // set by the implications
+    unsigned int nb_backjumps = 0u;                                     // branch nodes left because their grid was found contradictory
+    unsigned int nb_backjump_skipped_alternatives = 0u;
+    unsigned int nb_nogoods = 0u;                                       // learned by the branch search
+    unsigned int nb_nogood_hits = 0u;
+    unsigned int nb_branching_heuristic_choices = 0u;                   // branching calls on a line other than the one with the fewest alternatives
+    unsigned int nb_line_activity_bumps = 0u;                           // lines of the contradictions, see BranchingHeuristic::ACTIVITY
+    std::vector<std::uint64_t> max_nb_alternatives_by_branching_depth;  // vector with max_branching_depth elements
 };
 
 std::ostream& operator<<(std::ostream& out, const GridStats& stats);
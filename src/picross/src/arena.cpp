@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "arena.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace picross {
+
+Arena::Arena(std::size_t initial_block_size)
+    : m_blocks()
+    , m_current_block(0u)
+    , m_offset(0u)
+    , m_next_block_size(std::max(initial_block_size, std::size_t{64u}))
+{}
+
+Arena::~Arena() = default;
+
+Arena::Scope::Scope(Arena& arena)
+    : m_arena(arena)
+    , m_block(arena.m_current_block)
+    , m_offset(arena.m_offset)
+{}
+
+Arena::Scope::~Scope()
+{
+    // Scopes are nested
+    assert(m_block < m_arena.m_current_block || (m_block == m_arena.m_current_block && m_offset <= m_arena.m_offset));
+    m_arena.m_current_block = m_block;
+    m_arena.m_offset = m_offset;
+}
+
+void Arena::release()
+{
+    m_blocks.clear();
+    m_current_block = 0u;
+    m_offset = 0u;
+}
+
+std::size_t Arena::capacity() const
+{
+    std::size_t result = 0u;
+    for (const Block& block : m_blocks)
+        result += block.m_size;
+    return result;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    // Look for some room in the current block, then in the blocks left over by a previous scope
+    for (; m_current_block < m_blocks.size(); m_current_block++, m_offset = 0u)
+    {
+        const Block& block = m_blocks[m_current_block];
+        void* ptr = block.m_data.get() + m_offset;
+        std::size_t space = block.m_size - m_offset;
+        if (std::align(alignment, bytes, ptr, space))
+        {
+            m_offset = block.m_size - space + bytes;
+            return ptr;
+        }
+    }
+
+    // Allocate a new block
+    assert(m_current_block == m_blocks.size());
+    const std::size_t block_size = std::max(m_next_block_size, bytes + alignment);
+    m_next_block_size *= 2u;
+    const Block& block = m_blocks.emplace_back(Block{ std::make_unique<std::byte[]>(block_size), block_size });
+    void* ptr = block.m_data.get();
+    std::size_t space = block.m_size;
+    [[maybe_unused]] const void* aligned = std::align(alignment, bytes, ptr, space);
+    assert(aligned != nullptr);
+    m_offset = block.m_size - space + bytes;
+    return ptr;
+}
+
+void Arena::do_deallocate(void*, std::size_t, std::size_t)
+{
+    // The memory is reclaimed when a scope ends
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace picross
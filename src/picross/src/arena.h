@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Memory arena for the short-lived buffers of the solver
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace picross {
+
+/*
+ * Arena class
+ *
+ *   A monotonic memory resource: an allocation moves a cursor forward in a block of memory, and a deallocation is a no-op.
+ *   The memory is recycled by rewinding the cursor to a checkpoint taken earlier (see Arena::Scope), typically at the
+ *   beginning of a line reduction. The blocks obtained from the heap are kept until the arena is destroyed, so that the
+ *   solver reaches a steady state where its temporary buffers do not allocate.
+ *
+ *   The arena is not thread-safe.
+ */
+class Arena final : public std::pmr::memory_resource
+{
+public:
+    explicit Arena(std::size_t initial_block_size = 16384u);
+    ~Arena() override;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Rewind the arena at the end of the scope. The memory allocated in the scope must not be used afterwards.
+    class Scope
+    {
+    public:
+        explicit Scope(Arena& arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Arena&          m_arena;
+        std::size_t     m_block;
+        std::size_t     m_offset;
+    };
+
+    // Free all the blocks. Any memory allocated from the arena is invalidated.
+    void release();
+
+    std::size_t nb_blocks() const { return m_blocks.size(); }
+    std::size_t capacity() const;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    struct Block
+    {
+        std::unique_ptr<std::byte[]>    m_data;
+        std::size_t                     m_size;
+    };
+
+    std::vector<Block>  m_blocks;
+    std::size_t         m_current_block;            // Index of the block where the cursor is
+    std::size_t         m_offset;                   // Position of the cursor in the current block
+    std::size_t         m_next_block_size;
+};
+
+} // namespace picross
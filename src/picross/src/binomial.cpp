@@ -53,5 +53,12 @@ Rep Cache::partition_n_elts_into_k_buckets(unsigned int nb_elts, unsigned int nb
     return binomial_number;
 }
 
+void Cache::reserve(unsigned int max_nb_elts, unsigned int max_nb_buckets)
+{
+    for (unsigned int nb_buckets = 1u; nb_buckets <= max_nb_buckets; nb_buckets++)
+        for (unsigned int nb_elts = 0u; nb_elts <= max_nb_elts; nb_elts++)
+            partition_n_elts_into_k_buckets(nb_elts, nb_buckets);
+}
+
 } // namespace binomial
 } // namespace picross
@@ -15,7 +15,7 @@
 namespace picross {
 namespace binomial {
 
-using Rep = std::uint32_t;
+using Rep = std::uint64_t;
 
 /*
  * The max value returned for a number of alternatives (indicates overflow)
@@ -49,10 +49,10 @@ constexpr Rep& add(Rep& lhs, const Rep rhs) noexcept
  */
 constexpr Rep& mult(Rep& lhs, const Rep rhs) noexcept
 {
-    using MultInt = std::uint64_t;
-    static_assert(std::numeric_limits<Rep>::digits * 2 <= std::numeric_limits<MultInt>::digits);
-    const auto result = static_cast<MultInt>(lhs) *  static_cast<MultInt>(rhs);
-    lhs = result >= static_cast<MultInt>(overflowValue()) ? overflowValue() : static_cast<Rep>(result);
+    if (rhs != Rep{0} && lhs >= overflowValue() / rhs)
+        lhs = overflowValue();
+    else
+        lhs *= rhs;
     return lhs;
 }
 
@@ -77,6 +77,14 @@ public:
      */
     Rep partition_n_elts_into_k_buckets(unsigned int nb_elts, unsigned int nb_buckets);
 
+    /*
+     * Compute in advance the numbers for nb_elts <= max_nb_elts and nb_buckets <= max_nb_buckets.
+     *
+     * The cache is not modified anymore by a call to partition_n_elts_into_k_buckets() within those bounds, which can then
+     * be made concurrently.
+     */
+    void reserve(unsigned int max_nb_elts, unsigned int max_nb_buckets);
+
 private:
     std::vector<Rep> binomial_numbers;
 };
@@ -9,8 +9,6 @@
 
 #include <algorithm>
 #include <cassert>
-#include <functional>
-#include <type_traits>
 #include <utility>
 
 
@@ -37,6 +35,28 @@ namespace Tiles {
         return changed;
     }
 } // namespace Tiles
+
+    // Finalizer of the SplitMix64 generator
+    constexpr std::uint64_t mix(std::uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9u;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebu;
+        return x ^ (x >> 31);
+    }
+
+    // The Zobrist keys are computed on the fly instead of being stored in a table, since the grids have various sizes.
+    // The key of an unknown tile is zero.
+    inline std::uint64_t zobrist_key(std::size_t tile_idx, Tile tile)
+    {
+        assert(tile == Tile::UNKNOWN || tile == Tile::EMPTY || tile == Tile::FILLED);
+        return tile == Tile::UNKNOWN ? 0u : mix(2u * std::uint64_t{ tile_idx } + (tile == Tile::FILLED ? 1u : 0u));
+    }
+
+    // The hash of an unknown grid only depends on its size
+    inline std::uint64_t zobrist_seed(std::size_t width, std::size_t height)
+    {
+        return mix(mix(std::uint64_t{ width }) ^ std::uint64_t{ height });
+    }
 } // namespace
 
 
@@ -46,7 +66,14 @@ Grid::Grid(std::size_t width, std::size_t height, Tile init_tile, std::string_vi
     , m_name(name)
     , m_row_major(width * height, init_tile)
     , m_col_major(width * height, init_tile)
-{}
+    , m_hash(zobrist_seed(width, height))
+{
+    if (init_tile != Tile::UNKNOWN)
+    {
+        for (std::size_t idx = 0; idx < width * height; idx++)
+            m_hash ^= zobrist_key(idx, init_tile);
+    }
+}
 
 Grid& Grid::operator=(const Grid& other)
 {
@@ -54,6 +81,7 @@ Grid& Grid::operator=(const Grid& other)
     assert(m_height == other.m_height);
     m_row_major = other.m_row_major;
     m_col_major = other.m_col_major;
+    m_hash = other.m_hash;
     return *this;
 }
 
@@ -63,6 +91,7 @@ Grid& Grid::operator=(Grid&& other) noexcept
     assert(m_height == other.m_height);
     m_row_major = std::move(other.m_row_major);
     m_col_major = std::move(other.m_col_major);
+    m_hash = other.m_hash;
     return *this;
 }
 
@@ -102,7 +131,9 @@ bool Grid::set(Line::Index x, Line::Index y, Tile val)
 {
     assert(x < m_width);
     assert(y < m_height);
-    Tiles::set(m_row_major[y * m_width + x], val);
+    const std::size_t idx = y * m_width + x;
+    m_hash ^= zobrist_key(idx, m_row_major[idx]) ^ zobrist_key(idx, val);
+    Tiles::set(m_row_major[idx], val);
     return Tiles::set(m_col_major[x * m_height + y], val);
 }
 
@@ -110,7 +141,10 @@ bool Grid::update(Line::Index x, Line::Index y, Tile val)
 {
     assert(x < m_width);
     assert(y < m_height);
-    Tiles::update(m_row_major[y * m_width + x], val);
+    const std::size_t idx = y * m_width + x;
+    if (m_row_major[idx] == Tile::UNKNOWN)
+        m_hash ^= zobrist_key(idx, val);
+    Tiles::update(m_row_major[idx], val);
     return Tiles::update(m_col_major[x * m_height + y], val);
 }
 
@@ -120,49 +154,23 @@ void Grid::reset()
     {
         m_row_major[idx] = m_col_major[idx] = Tile::UNKNOWN;
     }
+    m_hash = zobrist_seed(m_width, m_height);
 }
 
 bool Grid::is_completed() const
 {
-    return std::all_of(std::cbegin(m_row_major), std::cend(m_row_major), [](const Tile& t) { return t != Tile::UNKNOWN; });
-}
-
-std::size_t Grid::hash() const
-{
-    // Intentionally ignore the name to compute the hash
-    std::size_t result = 0u;
-    result ^= std::hash<std::remove_const_t<decltype(m_width)>>{}(m_width);
-    result ^= std::hash<std::remove_const_t<decltype(m_height)>>{}(m_height);
-
-    // Encode the grid contents with pairs of booleans
-    std::vector<bool> grid_bool;
-    grid_bool.reserve(2 * m_width * m_height);
-    for (const Tile tile : m_row_major)
-    {
-        if (tile != Tile::UNKNOWN)
-        {
-            grid_bool.push_back(true);
-            grid_bool.push_back(tile != Tile::EMPTY);
-        }
-        else
-        {
-            grid_bool.push_back(false);
-            grid_bool.push_back(false);
-        }
-    }
-    assert(grid_bool.size() == 2 * m_width * m_height);
-
-    result ^= std::hash<decltype(grid_bool)>{}(grid_bool);
-
-    return result;
+    return tile_bits::is_completed(m_row_major.data(), m_row_major.size());
 }
 
 bool operator==(const Grid& lhs, const Grid& rhs)
 {
     // Intentionally ignore the name
-    return lhs.m_width == rhs.m_width
-        && lhs.m_height == rhs.m_height
-        && lhs.m_row_major == rhs.m_row_major;
+    if (lhs.m_width != rhs.m_width || lhs.m_height != rhs.m_height)
+        return false;
+    // Different hashes are a fast reject. Equal hashes may still collide, therefore the tiles decide.
+    if (lhs.m_hash != rhs.m_hash)
+        return false;
+    return lhs.m_row_major == rhs.m_row_major;
 }
 
 bool operator!=(const Grid& lhs, const Grid& rhs)
@@ -182,16 +190,15 @@ template <Line::Type T>
 GridSnapshot<T>::GridSnapshot(std::size_t width, std::size_t height)
     : m_width(width)
     , m_height(height)
-    , m_tiles()
+    , m_tiles(width * height)
 {
-    m_tiles.resize(width * height, Tile::UNKNOWN);
 }
 
 template <Line::Type T>
 GridSnapshot<T>::GridSnapshot(const Grid& grid)
     : m_width(grid.width())
     , m_height(grid.height())
-    , m_tiles(grid.get_container(T))
+    , m_tiles(grid.get_container(T).data(), grid.get_container(T).size())
 {
 }
 
@@ -217,29 +224,41 @@ GridSnapshot<T>& GridSnapshot<T>::operator=(const Grid& grid)
 {
     const_cast<std::size_t&>(m_width) = grid.width();
     const_cast<std::size_t&>(m_height) = grid.height();
-    m_tiles = grid.get_container(T);
+    m_tiles.assign(grid.get_container(T).data(), grid.get_container(T).size());
     return *this;
 }
 
 template <Line::Type T>
-LineSpan GridSnapshot<T>::get_line(Line::Index index) const
+Line GridSnapshot<T>::get_line(Line::Index index) const
 {
     assert((T == Line::ROW && index < m_height) || (T == Line::COL && index < m_width));
+    Line line(T, index, T == Line::ROW ? m_width : m_height);
+    copy_line_to(LineSpanW(line));
+    return line;
+}
+
+template <Line::Type T>
+void GridSnapshot<T>::copy_line_to(const LineSpanW& line) const
+{
+    assert(line.type() == T);
+    assert((T == Line::ROW && line.index() < m_height) || (T == Line::COL && line.index() < m_width));
     const auto line_length = T == Line::ROW ? m_width : m_height;
-    return LineSpan(T, index, line_length, &m_tiles[index * line_length]);
+    assert(line.size() == line_length);
+    m_tiles.copy_to(line.begin(), line.index() * line_length, line_length);
 }
 
 template <Line::Type T>
 void GridSnapshot<T>::reduce(const Grid& grid)
 {
     const Grid::Container& other_tiles = grid.get_container(T);
-    std::size_t idx {0};
-    for (Tile& tile : m_tiles)
-    {
-        if (tile != Tile::UNKNOWN && tile != other_tiles[idx])
-            tile = Tile::UNKNOWN;
-        idx++;
-    }
+    m_tiles.reduce(other_tiles.data(), other_tiles.size());
+}
+
+template <Line::Type T>
+void GridSnapshot<T>::reduce(const GridSnapshot<T>& other)
+{
+    assert(other.m_width == m_width && other.m_height == m_height);
+    m_tiles.reduce(other.m_tiles);
 }
 
 // Explicit template instantiation
@@ -6,10 +6,12 @@
 #pragma once
 
 #include "line_span.h"
+#include "tile_bits.h"
 
 #include <picross/picross.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <string_view>
@@ -51,13 +53,16 @@ public:
 
     bool is_completed() const;
 
-    std::size_t hash() const;
+    // Zobrist hash of the grid: the XOR of a random key for each known tile. It is maintained by set() and update(), so
+    // the cost of the hash is O(1).
+    std::size_t hash() const { return m_hash; }
 
     friend bool operator==(const Grid& lhs, const Grid& rhs);
     friend bool operator!=(const Grid& lhs, const Grid& rhs);
 
 protected:
-    // Use with great caution when writing, as only one of the two containers (row or column major) will be modified
+    // Use with great caution when writing, as only one of the two containers (row or column major) will be modified,
+    // and the hash of the grid is not updated
     template <typename TileT>
     LineSpanImpl<TileT> get_line_low_level(Line::Type type, Line::Index index);
 
@@ -67,10 +72,12 @@ private:
     const std::string       m_name;
     Container               m_row_major;
     Container               m_col_major;
+    std::uint64_t           m_hash;
 };
 
 std::ostream& operator<<(std::ostream& out, const Grid& grid);
 
+// A compact copy of the grid contents, stored as bit-planes
 template <Line::Type T>
 class GridSnapshot
 {
@@ -88,14 +95,18 @@ public:
     std::size_t width() const { return m_width; }
     std::size_t height() const { return m_height; }
 
-    LineSpan get_line(Line::Index index) const;
+    Line get_line(Line::Index index) const;
+    void copy_line_to(const LineSpanW& line) const;     // Same tiles as get_line(line.index()), written in the caller's buffer
 
     void reduce(const Grid& grid);
+    void reduce(const GridSnapshot& other);
+
+    std::size_t nb_known_tiles() const { return m_tiles.nb_filled() + m_tiles.nb_empty(); }
 
 private:
     const std::size_t       m_width;
     const std::size_t       m_height;
-    Grid::Container         m_tiles;
+    BitPlanes               m_tiles;
 };
 
 } // namespace picross
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "implication_graph.h"
+
+#include <cassert>
+
+namespace picross {
+
+namespace {
+    ImplicationGraph::Literal negation(const ImplicationGraph::Literal& literal)
+    {
+        return ImplicationGraph::Literal{ literal.m_x, literal.m_y, literal.m_tile == Tile::FILLED ? Tile::EMPTY : Tile::FILLED };
+    }
+} // namespace
+
+ImplicationGraph::ImplicationGraph(std::size_t width, std::size_t height, std::size_t max_nb_implications)
+    : m_width(width)
+    , m_height(height)
+    , m_max_nb_implications(max_nb_implications)
+    , m_heads()
+    , m_entries()
+    , m_marks()
+{
+}
+
+std::size_t ImplicationGraph::literal_index(const Literal& literal) const
+{
+    assert(literal.m_x < m_width && literal.m_y < m_height);
+    assert(literal.m_tile == Tile::EMPTY || literal.m_tile == Tile::FILLED);
+    return 2u * (static_cast<std::size_t>(literal.m_y) * m_width + literal.m_x) + (literal.m_tile == Tile::FILLED ? 1u : 0u);
+}
+
+void ImplicationGraph::add(const Literal& premise, const Literals& conclusions)
+{
+    if (m_heads.empty())
+    {
+        m_heads.resize(2u * m_width * m_height, 0u);
+        m_marks.resize(2u * m_width * m_height, 0);
+    }
+
+    // The premise and the negation of a conclusion are always added together, therefore checking the former is enough
+    const auto set_marks = [this](char mark) {
+        return [this, mark](const Literal& literal) { m_marks[literal_index(literal)] = mark; return true; };
+    };
+    for_each_implied(premise, set_marks(1));
+    for (const Literal& conclusion : conclusions)
+    {
+        if (m_entries.size() + 2u > m_max_nb_implications)
+            break;
+        if (m_marks[literal_index(conclusion)])
+            continue;
+        add_one(premise, conclusion);
+        add_one(negation(conclusion), negation(premise));
+    }
+    for_each_implied(premise, set_marks(0));
+}
+
+void ImplicationGraph::add_one(const Literal& premise, const Literal& conclusion)
+{
+    std::uint32_t& head = m_heads[literal_index(premise)];
+    m_entries.push_back(Entry{ conclusion, head });
+    head = static_cast<std::uint32_t>(m_entries.size());
+}
+
+} // namespace picross
@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Binary implications between the tiles of a grid, shared by the nested work grids
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include <picross/picross.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace picross {
+
+/*
+ * ImplicationGraph class
+ *
+ *   Implications "if tile A is set to value a, then tile B is set to value b", found by the cell probing. An implication
+ *   found on a grid remains true on any grid where more tiles are known, therefore the implications found on the root grid
+ *   hold for all of its nested grids. The contrapositive of an implication is stored as well.
+ *   The number of implications is bounded, and the memory of the graph is only allocated when the first one is added.
+ *   The implications of all the premises are stored in the same buffer, as linked lists, to limit the number of allocations.
+ */
+class ImplicationGraph
+{
+public:
+    struct Literal
+    {
+        Line::Index m_x;
+        Line::Index m_y;
+        Tile        m_tile;             // Either EMPTY or FILLED
+    };
+    using Literals = std::vector<Literal>;
+
+public:
+    ImplicationGraph(std::size_t width, std::size_t height, std::size_t max_nb_implications);
+
+    // Add the implications premise => conclusion for each of the conclusions, unless already known, and their contrapositives
+    void add(const Literal& premise, const Literals& conclusions);
+
+    // Call f on each of the literals implied by the premise, until f returns false. Return false in that case.
+    template <typename F>
+    bool for_each_implied(const Literal& premise, F&& f) const;
+
+    std::size_t nb_implications() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+private:
+    struct Entry
+    {
+        Literal         m_conclusion;
+        std::uint32_t   m_next;                 // Index of the next entry of the same premise, plus one. Zero at the end of the list.
+    };
+
+    std::size_t literal_index(const Literal& literal) const;
+    void add_one(const Literal& premise, const Literal& conclusion);
+
+private:
+    std::size_t                 m_width;
+    std::size_t                 m_height;
+    std::size_t                 m_max_nb_implications;
+    std::vector<std::uint32_t>  m_heads;        // Indexed by the premise. Index of its first entry, plus one
+    std::vector<Entry>          m_entries;
+    std::vector<char>           m_marks;        // Indexed by the conclusion
+};
+
+template <typename F>
+bool ImplicationGraph::for_each_implied(const Literal& premise, F&& f) const
+{
+    if (m_heads.empty())
+        return true;
+    for (std::uint32_t next = m_heads[literal_index(premise)]; next != 0u; next = m_entries[next - 1u].m_next)
+    {
+        if (!f(m_entries[next - 1u].m_conclusion))
+            return false;
+    }
+    return true;
+}
+
+} // namespace picross
@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "line_activity.h"
+
+namespace picross {
+
+namespace {
+    constexpr double DECAY = 0.95;
+    constexpr double RESCALE_THRESHOLD = 1e100;
+} // namespace
+
+LineActivity::LineActivity(std::size_t width, std::size_t height)
+    : m_height(height)
+    , m_activities(width + height, 0.0)
+    , m_increment(1.0)
+    , m_nb_bumps(0u)
+{
+}
+
+void LineActivity::bump(const LineId& line_id)
+{
+    m_activities[line_index(line_id)] += m_increment;
+    m_nb_bumps++;
+}
+
+void LineActivity::decay()
+{
+    m_increment /= DECAY;
+    if (m_increment > RESCALE_THRESHOLD)
+    {
+        for (double& activity : m_activities)
+            activity /= RESCALE_THRESHOLD;
+        m_increment /= RESCALE_THRESHOLD;
+    }
+}
+
+} // namespace picross
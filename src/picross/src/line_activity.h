@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Activity scores of the lines of a grid, shared by the nested work grids
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include <picross/picross.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace picross {
+
+/*
+ * LineActivity class
+ *
+ *   At each contradiction, the activity of the contradictory line and of the lines of the hypotheses it depends on is
+ *   bumped, then all the activities decay, such that the lines involved in the recent contradictions have the highest
+ *   scores (as in the VSIDS heuristic of the SAT solvers). The decay is implemented by increasing the amount of the next
+ *   bumps, and the scores are rescaled when they get too large.
+ */
+class LineActivity
+{
+public:
+    LineActivity(std::size_t width, std::size_t height);
+
+    void bump(const LineId& line_id);
+    void decay();
+    double activity(const LineId& line_id) const { return m_activities[line_index(line_id)]; }
+    unsigned int nb_bumps() const { return m_nb_bumps; }
+
+private:
+    std::size_t line_index(const LineId& line_id) const { return line_id.m_type == Line::ROW ? line_id.m_index : m_height + line_id.m_index; }
+
+private:
+    std::size_t                 m_height;
+    std::vector<double>         m_activities;       // The rows, then the columns
+    double                      m_increment;
+    unsigned int                m_nb_bumps;
+};
+
+} // namespace picross
@@ -9,6 +9,7 @@
 #include "line.h"
 #include "line_constraint.h"
 #include "line_span.h"
+#include "tile_bits.h"
 
 #include <stdutils/span.h>
 
@@ -18,7 +19,8 @@
 #include <iterator>
 #include <limits>
 #include <memory>
-#include <tuple>
+#include <memory_resource>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
@@ -92,13 +94,7 @@ namespace {
     void reduce_alternative(LineSpanW& reduced_line, const LineSpan& alternative)
     {
         assert(reduced_line.size() == alternative.size());
-        const int line_sz = static_cast<int>(reduced_line.size());
-        for (int idx = 0; idx < line_sz; idx++)
-        {
-            auto& reduced_tile = reduced_line[idx];
-            if (reduced_tile != Tile::UNKNOWN && reduced_tile != alternative[idx])
-                reduced_tile = Tile::UNKNOWN;
-        }
+        tile_bits::reduce(reduced_line.tiles(), alternative.tiles(), reduced_line.size());
     }
 
     struct ReducedLine
@@ -128,29 +124,33 @@ namespace {
         bool      m_reset;
     };
 
-    LineAlternatives::Reduction from_line(const LineSpan& line, LineAlternatives::NbAlt nb_alt, bool full)
+    // The reduced line of the result is already written
+    void set_result(LineAlternatives::Reduction& result, LineAlternatives::NbAlt nb_alt, bool full)
     {
-        LineAlternatives::Reduction result;
-        result.reduced_line = line_from_line_span(line);
         result.nb_alternatives = nb_alt;
         result.is_fully_reduced = full;
-        return result;
+    }
+
+    void set_result(LineAlternatives::Reduction& result, const LineSpan& line, LineAlternatives::NbAlt nb_alt, bool full)
+    {
+        copy_line_span(result.reduced_line, line);
+        set_result(result, nb_alt, full);
     }
 
     // A Line with extra tiles at index -1 and line_sz
     class LineExt
     {
     public:
-        LineExt(const LineSpan& line_span, Tile init_tile)
-            : m_tiles(line_span.size() + 2u, init_tile)
+        LineExt(const LineSpan& line_span, Tile init_tile, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+            : m_tiles(line_span.size() + 2u, init_tile, memory)
             , m_line_span(line_span.type(), line_span.index(), line_span.size(), m_tiles.data() + 1u)
         {
             m_tiles.front() = Tile::EMPTY;
             m_tiles.back() = Tile::EMPTY;
         }
 
-        LineExt(const LineSpan& line_span)
-            : LineExt(line_span, Tile::UNKNOWN)
+        LineExt(const LineSpan& line_span, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+            : LineExt(line_span, Tile::UNKNOWN, memory)
         {
             copy_line_span(m_line_span, line_span);
         }
@@ -158,7 +158,7 @@ namespace {
         LineSpan const_line_span() const { return LineSpan(m_line_span); }
         LineSpanW& line_span() { return m_line_span; }
     private:
-        Line::Container m_tiles;
+        std::pmr::vector<Tile> m_tiles;
         LineSpanW m_line_span;
     };
 
@@ -166,9 +166,9 @@ namespace {
     class LineExtArray
     {
     public:
-        LineExtArray(const LineSpan& line_span, std::size_t count, Tile init_tile)
-            : m_tiles(count * (line_span.size() + 1u) + 1u, init_tile)
-            , m_line_spans()
+        LineExtArray(const LineSpan& line_span, std::size_t count, Tile init_tile, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+            : m_tiles(count * (line_span.size() + 1u) + 1u, init_tile, memory)
+            , m_line_spans(memory)
         {
             m_tiles[0] = Tile::EMPTY;
             for (std::size_t c = 1u; c <= count; c++)
@@ -181,12 +181,17 @@ namespace {
         LineSpan const_line_span(int idx) const { assert(idx >=0); return LineSpan(m_line_spans[static_cast<unsigned int>(idx)]); }
         LineSpanW& line_span(int idx)      { assert(idx >=0); return m_line_spans[static_cast<unsigned int>(idx)]; }
     private:
-        Line::Container             m_tiles;
-        std::vector<LineSpanW> m_line_spans;
+        std::pmr::vector<Tile>      m_tiles;
+        std::pmr::vector<LineSpanW> m_line_spans;
     };
 } // namespace
 
 
+LineAlternatives::Reduction reduction_of_line(const LineSpan& line)
+{
+    return LineAlternatives::Reduction { Line(line.type(), line.index(), line.size()), LineAlternatives::NbAlt{0}, false };
+}
+
 std::ostream& operator<<(std::ostream& out, const SegmentRange& segment_range)
 {
     out << "SegmentRange{ left=" << segment_range.m_leftmost_index << ", right=" << segment_range.m_rightmost_index << " }";
@@ -200,6 +205,12 @@ std::ostream& operator<<(std::ostream& out, const LineHole& line_hole)
 }
 
 std::vector<LineHole> line_holes(const LineSpan& known_tiles, int line_begin, int line_end)
+{
+    const auto holes = line_holes(known_tiles, line_begin, line_end, std::pmr::get_default_resource());
+    return std::vector<LineHole>(holes.cbegin(), holes.cend());
+}
+
+std::pmr::vector<LineHole> line_holes(const LineSpan& known_tiles, int line_begin, int line_end, std::pmr::memory_resource* memory)
 {
     if (line_end == -1)
     {
@@ -208,7 +219,7 @@ std::vector<LineHole> line_holes(const LineSpan& known_tiles, int line_begin, in
     assert(line_begin >= 0);
     assert(line_begin <= line_end);
     assert(line_end <= static_cast<int>(known_tiles.size()));
-    std::vector<LineHole> result;
+    std::pmr::vector<LineHole> result(memory);
     result.reserve(static_cast<std::size_t>((line_end - line_begin) / 2));
     bool new_hole = true;
     unsigned int* p_current_length = nullptr;
@@ -234,14 +245,14 @@ std::vector<LineHole> line_holes(const LineSpan& known_tiles, int line_begin, in
 
 
 namespace {
-    std::pair<bool, std::vector<SegmentRange>> local_find_segments_range(const LineSpan& known_tiles, const BidirectionalRange<false>& range)
+    std::pair<bool, std::pmr::vector<SegmentRange>> local_find_segments_range(const LineSpan& known_tiles, const BidirectionalRange<false>& range, std::pmr::memory_resource* memory)
     {
         const auto nb_segments = static_cast<std::size_t>(std::distance(range.m_constraint_begin, range.m_constraint_end));
-        std::vector<SegmentRange> result(nb_segments, SegmentRange{0, 0});
+        std::pmr::vector<SegmentRange> result(nb_segments, SegmentRange{0, 0}, memory);
         bool success = false;
 
-        auto l_holes = line_holes(known_tiles, range.m_line_begin, range.m_line_end);
-        auto r_holes = l_holes;
+        auto l_holes = line_holes(known_tiles, range.m_line_begin, range.m_line_end, memory);
+        std::pmr::vector<LineHole> r_holes(l_holes, memory);
 
         // Identify the leftmost configuration of the segments
         {
@@ -337,16 +348,29 @@ namespace {
         return (n * (n + 1)) / 2;
     }
 
+    // Size required by the line buffer used for the recursive full reduction (it is in O(k.n^2))
+    std::size_t reduced_lines_buffer_size(unsigned int max_k, unsigned int max_line_length)
+    {
+        return max_k * arithmetic_sum_up_to(max_line_length);
+    }
+
+    struct TailReduceBuffers
+    {
+        TailReduceBuffers(unsigned int max_k, unsigned int max_line_length)
+            : m_line_buffer(Line::ROW, 0, reduced_lines_buffer_size(max_k, max_line_length), Tile::UNKNOWN)
+            , m_alts_buffer(max_k * max_line_length, LineAlternatives::NbAlt{0})
+            , m_bool_buffer(max_k * max_line_length, 0)
+        {}
+
+        Line                                    m_line_buffer;
+        std::vector<LineAlternatives::NbAlt>    m_alts_buffer;
+        std::vector<char>                       m_bool_buffer;
+    };
+
     class TailReduceArray
     {
     public:
-        // Size required by the line buffer used for the full reduction (it is in O(k.n^2))
-        static std::size_t reduced_lines_buffer_size(unsigned int max_k, unsigned int max_line_length)
-        {
-            return max_k * arithmetic_sum_up_to(max_line_length);
-        }
-    public:
-        TailReduceArray(Line::Type type, Line::Index index, unsigned int max_k, unsigned int max_line_length, FullReductionBuffers& buffers)
+        TailReduceArray(Line::Type type, Line::Index index, unsigned int max_k, unsigned int max_line_length, TailReduceBuffers& buffers)
             : m_all_reduced_lines(type, index, reduced_lines_buffer_size(max_k, max_line_length), buffers.m_line_buffer.begin())
             , m_nb_alternatives(buffers.m_alts_buffer.data(), max_k * max_line_length)
             , m_recorded(buffers.m_bool_buffer.data(), max_k * max_line_length)
@@ -405,18 +429,113 @@ namespace {
         unsigned int                            m_max_line_length;
     };
 
+    // Prefix counts of the empty and filled tiles of a line, such that the number of empty (resp. filled) tiles in a range is computed in O(1)
+    class TilesPrefixCounts
+    {
+    public:
+        explicit TilesPrefixCounts(std::size_t line_size, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+            : m_line_size(line_size)
+            , m_counts(2u * (line_size + 1u), 0u, memory)
+        {}
+
+        TilesPrefixCounts(const TilesPrefixCounts& other, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+            : m_line_size(other.m_line_size)
+            , m_counts(other.m_counts, memory)
+        {}
+        TilesPrefixCounts& operator=(const TilesPrefixCounts&) = delete;
+
+        // Recompute the prefix counts from index from_idx to the end of the line
+        template <typename TileT>
+        void compute(const LineSpanImpl<TileT>& line, int from_idx = 0)
+        {
+            assert(line.size() == m_line_size);
+            assert(0 <= from_idx && from_idx <= static_cast<int>(m_line_size));
+            unsigned int* empty = m_counts.data();
+            unsigned int* filled = m_counts.data() + m_line_size + 1u;
+            for (auto idx = static_cast<std::size_t>(from_idx); idx < m_line_size; idx++)
+            {
+                const Tile tile = line.tiles()[idx];
+                empty[idx + 1] = empty[idx] + (tile == Tile::EMPTY ? 1u : 0u);
+                filled[idx + 1] = filled[idx] + (tile == Tile::FILLED ? 1u : 0u);
+            }
+        }
+
+        // Nb of empty tiles in the range [begin, end)
+        unsigned int nb_empty(int begin, int end) const
+        {
+            assert(0 <= begin && begin <= end && end <= static_cast<int>(m_line_size));
+            const unsigned int* empty = m_counts.data();
+            return empty[end] - empty[begin];
+        }
+
+        // Nb of filled tiles in the range [begin, end)
+        unsigned int nb_filled(int begin, int end) const
+        {
+            assert(0 <= begin && begin <= end && end <= static_cast<int>(m_line_size));
+            const unsigned int* filled = m_counts.data() + m_line_size + 1u;
+            return filled[end] - filled[begin];
+        }
+
+    private:
+        std::size_t                 m_line_size;
+        std::pmr::vector<unsigned int> m_counts;    // Prefix counts of the empty tiles, followed by the prefix counts of the filled tiles
+    };
+
+    // ref_line is an extended line, the tiles at index -1 and line_sz are readable
     template <typename TileT>
-    bool check_ref_line_compatibility_bw_segment(const LineSpanImpl<TileT>& ref_line, int segment_begin_index, unsigned int segment_length)
+    bool check_ref_line_compatibility_bw_segment(const LineSpanImpl<TileT>& ref_line, const TilesPrefixCounts& ref_counts, int segment_begin_index, unsigned int segment_length)
     {
         const int segment_end_index = segment_begin_index + static_cast<int>(segment_length);
         if (ref_line[segment_begin_index - 1] == Tile::FILLED || ref_line[segment_end_index] == Tile::FILLED)
             return false;
-        for (int idx = segment_begin_index; idx < segment_end_index; idx++)
-            if (ref_line[idx] == Tile::EMPTY)
-                return false;
-        return true;
+        return ref_counts.nb_empty(segment_begin_index, segment_end_index) == 0u;
+    }
+
+    // Partial sums of the segment lengths: result[j] = s_0 + ... + s_j-1
+    std::vector<unsigned int> segments_partial_sums(const Segments& segments)
+    {
+        std::vector<unsigned int> result(segments.size() + 1u, 0u);
+        for (std::size_t j = 0u; j < segments.size(); j++)
+            result[j + 1] = result[j] + segments[j];
+        return result;
+    }
+
+    // Record that a tile can take the value tile_value in at least one alternative. Once a tile was found to be
+    // possibly empty and possibly filled, it is set to the value TILE_EMPTY_OR_FILLED, which must then be
+    // replaced by Tile::UNKNOWN.
+    constexpr auto TILE_EMPTY_OR_FILLED = static_cast<Tile>(static_cast<unsigned char>(Tile::EMPTY) | static_cast<unsigned char>(Tile::FILLED));
+    inline void add_possible_value(Tile& tile, Tile tile_value)
+    {
+        tile = static_cast<Tile>(static_cast<unsigned char>(tile) | static_cast<unsigned char>(tile_value));
+    }
+
+    // Add a possible value to the tiles [begin, end), knowing that the tiles before covered_until are already done.
+    // The successive calls must be with increasing values of begin.
+    inline void add_possible_value(LineSpanW& line, int begin, int end, Tile tile_value, int& covered_until)
+    {
+        for (int idx = std::max(begin, covered_until); idx < end; idx++)
+            add_possible_value(line[idx], tile_value);
+        covered_until = std::max(covered_until, end);
     }
 
+    // The DP tables of the full reduction are only kept between two calls if their size is below that limit.
+    // Larger tables are computed in the shared FullReductionBuffers.
+    constexpr std::size_t MAX_PERSISTENT_DP_TABLE_SIZE = 1u << 12;
+
+    // The DP tables of the full reduction and the known tiles they were computed with. Kept between two calls
+    // to LineAlternatives::full_reduction(), in order to only recompute the columns affected by the tiles that changed.
+    struct FullReductionTables
+    {
+        bool                                    m_valid = false;
+        int                                     m_line_begin = 0;
+        int                                     m_line_end = 0;
+        std::ptrdiff_t                          m_constraint_begin = 0;
+        std::ptrdiff_t                          m_constraint_end = 0;
+        std::vector<LineAlternatives::NbAlt>    m_forward;
+        std::vector<LineAlternatives::NbAlt>    m_backward;
+        Line::Container                         m_tiles;
+    };
+
 } // namespace
 
 
@@ -427,8 +546,9 @@ struct LineAlternatives::Impl
 
     void reset();
 
-    template <bool Reversed, typename TileT>
-    bool check_compatibility_bw(const LineSpanImpl<TileT>& alternative, int start_idx, int end_idx) const;
+    // Return true if the tiles in the range [start_idx, end_idx) can all be empty, resp. all filled
+    bool check_compatibility_bw_empty(int start_idx, int end_idx) const;
+    bool check_compatibility_bw_filled(int start_idx, int end_idx) const;
 
     bool check_compatibility_bw_segment(int segment_begin_index, unsigned int segment_length) const;
 
@@ -445,9 +565,9 @@ struct LineAlternatives::Impl
     void next_segment_max_index(int& next_segment_index, unsigned int segment_length, int max_segment_index) const;
     void prev_segment_min_index(int& prev_segment_index, unsigned int prev_segment_length, int min_segment_index) const;
 
-    bool narrow_down_segments_range(std::vector<SegmentRange>& ranges) const;
+    bool narrow_down_segments_range(std::pmr::vector<SegmentRange>& ranges) const;
 
-    LineAlternatives::Reduction linear_reduction(const std::vector<SegmentRange>& ranges);
+    void linear_reduction(Reduction& result, const std::pmr::vector<SegmentRange>& ranges, std::pmr::memory_resource* memory);
 
     TailReduce reduce_all_alternatives_recursive(
         LineSpanW& alternative,
@@ -458,14 +578,26 @@ struct LineAlternatives::Impl
         const int line_begin,
         const int line_end);
 
-    Reduction reduce_all_alternatives(FullReductionBuffers* buffers = nullptr);
+    void reduce_all_alternatives_recursive(Reduction& result);
+
+    void reduce_all_alternatives(Reduction& result, FullReductionBuffers* buffers = nullptr);
+
+    // Full reduction kernels specialized for lines with 0, 1 or 2 segments left after update()
+    std::size_t nb_remaining_segments() const;
+    void reduce_no_segment(Reduction& result) const;
+    void reduce_one_segment(Reduction& result) const;
+    void reduce_two_segments(Reduction& result) const;
 
     const Segments&                     m_segments;
+    std::vector<unsigned int>           m_segments_partial_sums;
     const LineSpan                      m_known_tiles;
     LineExt                             m_known_tiles_extended_copy;
     const LineSpan                      m_known_tiles_ext;
+    TilesPrefixCounts                   m_known_tiles_counts;
+    FullReductionTables                 m_full_reduction_tables;
     binomial::Cache&                    m_binomial;
     const unsigned int                  m_line_length;
+    const unsigned int                  m_min_line_size;
     unsigned int                        m_remaining_zeros;
     BidirectionalRange<false>           m_bidirectional_range;
     BidirectionalRange<true>            m_bidirectional_range_reverse;
@@ -473,12 +605,15 @@ struct LineAlternatives::Impl
 
 LineAlternatives::Impl::Impl(const LineConstraint& constraints, const LineSpan& known_tiles, binomial::Cache& binomial)
     : m_segments(constraints.segments())
+    , m_segments_partial_sums(segments_partial_sums(constraints.segments()))
     , m_known_tiles(known_tiles)
     , m_known_tiles_extended_copy(known_tiles)
     , m_known_tiles_ext(m_known_tiles_extended_copy.line_span())
+    , m_known_tiles_counts(known_tiles.size())
     , m_binomial(binomial)
     , m_line_length(static_cast<unsigned int>(known_tiles.size()))
-    , m_remaining_zeros(m_line_length - constraints.min_line_size())
+    , m_min_line_size(constraints.min_line_size())
+    , m_remaining_zeros(m_line_length - m_min_line_size)
     , m_bidirectional_range(constraints.segments(), m_line_length)
     , m_bidirectional_range_reverse(constraints.segments(), m_line_length)
 {
@@ -487,11 +622,14 @@ LineAlternatives::Impl::Impl(const LineConstraint& constraints, const LineSpan&
 
 LineAlternatives::Impl::Impl(const Impl& other, const LineSpan& known_tiles)
     : m_segments(other.m_segments)
+    , m_segments_partial_sums(other.m_segments_partial_sums)
     , m_known_tiles(known_tiles)
     , m_known_tiles_extended_copy(known_tiles)
     , m_known_tiles_ext(m_known_tiles_extended_copy.line_span())
+    , m_known_tiles_counts(known_tiles.size())
     , m_binomial(other.m_binomial)
     , m_line_length(other.m_line_length)
+    , m_min_line_size(other.m_min_line_size)
     , m_remaining_zeros(other.m_remaining_zeros)
     , m_bidirectional_range(other.m_bidirectional_range)
     , m_bidirectional_range_reverse(other.m_bidirectional_range_reverse)
@@ -501,42 +639,33 @@ LineAlternatives::Impl::Impl(const Impl& other, const LineSpan& known_tiles)
 
 void LineAlternatives::Impl::reset()
 {
-    m_remaining_zeros = m_line_length - compute_min_line_size(m_segments);
+    m_remaining_zeros = m_line_length - m_min_line_size;
     m_bidirectional_range = BidirectionalRange<false>(m_segments, m_line_length);
     m_bidirectional_range_reverse = BidirectionalRange<true>(m_segments, m_line_length);
+    m_full_reduction_tables.m_valid = false;
 }
 
-template <bool Reversed, typename TileT>
-bool LineAlternatives::Impl::check_compatibility_bw(const LineSpanImpl<TileT>& alternative, int start_idx, int end_idx) const
+bool LineAlternatives::Impl::check_compatibility_bw_empty(int start_idx, int end_idx) const
 {
-    static_assert(static_cast<TileImpl>(Tile::UNKNOWN) == 0);
-    static constexpr TileImpl INCOMPATIBLE_SUM = static_cast<TileImpl>(Tile::EMPTY) + static_cast<TileImpl>(Tile::FILLED);
-    assert(start_idx <= end_idx);
-    for (int idx = start_idx; idx < end_idx; ++idx)
-    {
-        const auto trans_idx = IndexTranslation<Reversed>()(m_line_length, idx);
-        if (static_cast<TileImpl>(m_known_tiles[trans_idx]) + static_cast<TileImpl>(alternative[trans_idx]) == INCOMPATIBLE_SUM)
-            return false;
-    }
-    return true;
+    return m_known_tiles_counts.nb_filled(start_idx, end_idx) == 0u;
+}
+
+bool LineAlternatives::Impl::check_compatibility_bw_filled(int start_idx, int end_idx) const
+{
+    return m_known_tiles_counts.nb_empty(start_idx, end_idx) == 0u;
 }
 
 // Returns true if the segment matches the current known tiles
 bool LineAlternatives::Impl::check_compatibility_bw_segment(int segment_begin_index, unsigned int segment_length) const
 {
-    return check_ref_line_compatibility_bw_segment(m_known_tiles_ext, segment_begin_index, segment_length);
+    return check_ref_line_compatibility_bw_segment(m_known_tiles_ext, m_known_tiles_counts, segment_begin_index, segment_length);
 }
 
 unsigned int LineAlternatives::Impl::nb_unknown_tiles() const
 {
     const auto& range = m_bidirectional_range;
-    unsigned int count = 0;
-    for (auto idx = range.m_line_begin; idx < range.m_line_end; idx++)
-    {
-        if (m_known_tiles[idx] == Tile::UNKNOWN)
-            count++;
-    }
-    return count;
+    assert(range.m_line_begin <= range.m_line_end);
+    return static_cast<unsigned int>(tile_bits::nb_unknown(m_known_tiles.tiles() + range.m_line_begin, static_cast<std::size_t>(range.m_line_end - range.m_line_begin)));
 }
 
 template <>
@@ -593,8 +722,9 @@ bool LineAlternatives::Impl::update_range()
 
 bool LineAlternatives::Impl::update()
 {
-    // Update the extended copy of the known tiles
+    // Update the extended copy of the known tiles and its prefix counts
     copy_line_span(m_known_tiles_extended_copy.line_span(), m_known_tiles);
+    m_known_tiles_counts.compute(m_known_tiles);
 
     auto& range_l = bidirectional_range<false>();
     auto& range_r = bidirectional_range<true>();
@@ -659,7 +789,7 @@ void LineAlternatives::Impl::prev_segment_min_index(int& prev_segment_index, uns
     }
 }
 
-bool LineAlternatives::Impl::narrow_down_segments_range(std::vector<SegmentRange>& ranges) const
+bool LineAlternatives::Impl::narrow_down_segments_range(std::pmr::vector<SegmentRange>& ranges) const
 {
     const auto nb_segments = ranges.size();
     const auto constraint_begin = m_bidirectional_range.m_constraint_begin;
@@ -717,7 +847,7 @@ bool LineAlternatives::Impl::narrow_down_segments_range(std::vector<SegmentRange
 }
 
 // Linear reduction considers each segment independently, therefore leading to a O(k.n) reduction, where k is the number of segment and n is the line length
-LineAlternatives::Reduction LineAlternatives::Impl::linear_reduction(const std::vector<SegmentRange>& ranges)
+void LineAlternatives::Impl::linear_reduction(Reduction& result, const std::pmr::vector<SegmentRange>& ranges, std::pmr::memory_resource* memory)
 {
     assert(m_known_tiles == LineSpan(m_known_tiles_ext));     // Assert that update() was called
 
@@ -727,7 +857,7 @@ LineAlternatives::Reduction LineAlternatives::Impl::linear_reduction(const std::
     const auto line_end = m_bidirectional_range.m_line_end;
     assert(nb_segments == static_cast<std::size_t>(std::distance(constraint_it, m_bidirectional_range.m_constraint_end)));
 
-    LineExtArray tiles_masks(m_known_tiles, 1u, Tile::UNKNOWN);
+    LineExtArray tiles_masks(m_known_tiles, 1u, Tile::UNKNOWN, memory);
 
     // empty_tiles_mask:  '0??000000?????0'
     LineSpanW& empty_tiles_mask = tiles_masks.line_span(0);
@@ -735,11 +865,13 @@ LineAlternatives::Reduction LineAlternatives::Impl::linear_reduction(const std::
     for (int idx = line_begin; idx < line_end; idx++) { empty_tiles_mask[idx] = Tile::EMPTY; }
     for (int idx = line_end; idx < static_cast<int>(m_line_length); idx++) { empty_tiles_mask[idx] = Tile::UNKNOWN; }
 
-    LineExt reduction_mask_extended_line(m_known_tiles);
+    LineExt reduction_mask_extended_line(m_known_tiles, memory);
     LineSpanW& reduction_mask = reduction_mask_extended_line.line_span();
     assert(reduction_mask == m_known_tiles_ext);
+    const TilesPrefixCounts* reduction_mask_counts = &m_known_tiles_counts;
+    std::optional<TilesPrefixCounts> updated_reduction_mask_counts;     // Only allocated if the reduction mask has new empty tiles
 
-    Reduction result = from_line(m_known_tiles, 1, false);
+    set_result(result, m_known_tiles, 1, false);
     LineSpanW reduced_line(result.reduced_line);
     for (std::size_t k = 0; k < nb_segments; k++)
     {
@@ -750,7 +882,7 @@ LineAlternatives::Reduction LineAlternatives::Impl::linear_reduction(const std::
         const unsigned int seg_length = *constraint_it;
         for (int seg_index = ranges[k].m_leftmost_index; seg_index <= ranges[k].m_rightmost_index; seg_index++)
         {
-            if (check_ref_line_compatibility_bw_segment(reduction_mask, seg_index, seg_length))
+            if (check_ref_line_compatibility_bw_segment(reduction_mask, *reduction_mask_counts, seg_index, seg_length))
             {
                 nb_alt++;
                 min_index = std::min(min_index, seg_index);
@@ -768,6 +900,10 @@ LineAlternatives::Reduction LineAlternatives::Impl::linear_reduction(const std::
             assert(min_index == max_index);
             reduction_mask[min_index - 1] = Tile::EMPTY;
             reduction_mask[min_index + static_cast<int>(seg_length)] = Tile::EMPTY;
+            if (!updated_reduction_mask_counts)
+                updated_reduction_mask_counts.emplace(m_known_tiles_counts, memory);
+            updated_reduction_mask_counts->compute(reduction_mask, std::max(0, min_index - 1));
+            reduction_mask_counts = &*updated_reduction_mask_counts;
         }
         if (nb_alt > 0)
         {
@@ -817,8 +953,6 @@ LineAlternatives::Reduction LineAlternatives::Impl::linear_reduction(const std::
     }
 
     result.is_fully_reduced = (result.nb_alternatives == 1);
-
-    return result;
 }
 
 TailReduce LineAlternatives::Impl::reduce_all_alternatives_recursive(
@@ -877,7 +1011,9 @@ TailReduce LineAlternatives::Impl::reduce_all_alternatives_recursive(
             alternative_tail[next_line_idx] = Tile::EMPTY;
             next_line_idx += nb_ones;
             alternative_tail[next_line_idx++] = Tile::FILLED;
-            if (check_compatibility_bw<false>(alternative, line_begin, line_end))
+            const int ones_begin = line_begin + pre_zeros;
+            const int ones_end = ones_begin + nb_ones;
+            if (check_compatibility_bw_empty(line_begin, ones_begin) && check_compatibility_bw_filled(ones_begin, ones_end) && check_compatibility_bw_empty(ones_end, line_end))
             {
                 reduced_line_tail.reduce(alternative_tail);
                 nb_alt++;
@@ -894,8 +1030,9 @@ TailReduce LineAlternatives::Impl::reduce_all_alternatives_recursive(
             next_line_idx += nb_ones;
             alternative_tail[next_line_idx++] = Tile::FILLED;
             alternative_tail[next_line_idx++] = Tile::EMPTY;        // Terminating empty tile
-            // TODO: The limiting factor for performance is probably here: O(n) calls to a linear function check_compatibility_bw.
-            if (check_compatibility_bw<false>(alternative, line_begin, line_begin + next_line_idx))
+            const int ones_begin = line_begin + pre_zeros;
+            const int ones_end = ones_begin + nb_ones;
+            if (check_compatibility_bw_empty(line_begin, ones_begin) && check_compatibility_bw_filled(ones_begin, ones_end) && check_compatibility_bw_empty(ones_end, ones_end + 1))
             {
                 assert(line_begin + next_line_idx <= line_end);
                 const int tail_sz = line_end - line_begin - next_line_idx;
@@ -921,48 +1058,423 @@ TailReduce LineAlternatives::Impl::reduce_all_alternatives_recursive(
 
 // Line solver that performs a full reduction: all alternatives are theoritically explored and "reduced" to a line which contains all the tiles
 // that can be deduced from the input contraints and known tiles. In addition, the alogrithm returns the total number of alternative solutions.
+// This is the recursive implementation, kept as a reference for the dynamic programming one below.
 // With:
 //  k = numbers of constraints
 //  n = length of the line
-// Time complexity :   O(k.n^3)   (can surely be brought down to O(k.n^2))
+// Time complexity :   O(k.n^3)
 // Memory complexity : O(k.n^2)   (the quadratic size memory buffer is freed at the end of the full_reduction)
-LineAlternatives::Reduction LineAlternatives::Impl::reduce_all_alternatives(FullReductionBuffers* buffers)
+void LineAlternatives::Impl::reduce_all_alternatives_recursive(Reduction& result)
 {
     const auto& range_l = m_bidirectional_range;
-    Line reduced_line_raw = line_from_line_span(m_known_tiles);
-    LineSpanW reduced_line(reduced_line_raw);
+    copy_line_span(result.reduced_line, m_known_tiles);
+    LineSpanW reduced_line(result.reduced_line);
     if ((range_l.m_constraint_begin == range_l.m_constraint_end) || (range_l.m_line_begin == range_l.m_line_end))
     {
         for (int idx = range_l.m_line_begin; idx < range_l.m_line_end; idx++)
         {
             reduced_line[idx] = Tile::EMPTY;
         }
-        const bool match = check_compatibility_bw<false>(reduced_line, range_l.m_line_begin, range_l.m_line_end);
-        return Reduction { std::move(reduced_line_raw), match ? NbAlt{1} : NbAlt{0}, true };
+        const bool match = check_compatibility_bw_empty(range_l.m_line_begin, range_l.m_line_end);
+        return set_result(result, match ? NbAlt{1} : NbAlt{0}, true);
     }
     else
     {
         assert(range_l.m_line_begin < range_l.m_line_end);
         LineExt alternative_buffer(m_known_tiles);
         const auto k = static_cast<unsigned int>(std::distance(range_l.m_constraint_begin, range_l.m_constraint_end));
-        std::unique_ptr<FullReductionBuffers> reduction_buffers;
-        if (!buffers)
-        {
-            reduction_buffers = std::make_unique<FullReductionBuffers>(k, m_line_length);
-            buffers = reduction_buffers.get();
-        }
-        assert(buffers);
-        TailReduceArray tail_reduce_array(m_known_tiles.type(), m_known_tiles.index(), k, m_line_length, *buffers);
+        TailReduceBuffers buffers(k, m_line_length);
+        TailReduceArray tail_reduce_array(m_known_tiles.type(), m_known_tiles.index(), k, m_line_length, buffers);
         const auto reduction = reduce_all_alternatives_recursive(alternative_buffer.line_span(), tail_reduce_array, static_cast<int>(m_remaining_zeros), range_l.m_constraint_begin, range_l.m_constraint_end, range_l.m_line_begin, range_l.m_line_end);
         for (int idx = range_l.m_line_begin; idx < range_l.m_line_end; idx++)
         {
             reduced_line[idx] = reduction.m_reduced_tail[idx - range_l.m_line_begin];
         }
-        return Reduction { std::move(reduced_line_raw), reduction.m_nb_alt, true };
+        return set_result(result, reduction.m_nb_alt, true);
+    }
+}
+
+// Line solver that performs a full reduction, same result as reduce_all_alternatives_recursive() but with a dynamic programming approach.
+// On the line range [0, m) remaining after the trimming of the completed segments at both ends, with segments s_0, ..., s_k-1:
+//  - Forward sweep:  F(j, x) = nb of alternatives for the segments s_0, ..., s_j-1 on the tiles [0, x)
+//  - Backward sweep: B(j, x) = nb of alternatives for the segments s_j, ..., s_k-1 on the tiles [x, m)
+// Then:
+//  - The total nb of alternatives is F(k, m) = B(0, 0)
+//  - Tile x can be empty if there is j such that F(j, x) > 0 and B(j, x + 1) > 0
+//  - Tile x can be filled if it is covered by a valid placement of a segment s_j at [a, a + s_j), that is a placement
+//    with no empty tile in it, and such that the alternatives on its left and on its right are not zero.
+// The counts are saturated (see binomial::add), which does not change whether they are zero or not.
+// For a given j, only a window of z + 1 values of x are relevant, z being the number of remaining zeros on the line.
+// The tables are kept between two calls: F(., x) only depends on the tiles [0, x), and B(., x) on the tiles [x, m), therefore
+// only the columns on the right of the first changed tile (resp. on the left of the last changed tile) need to be updated.
+// Time complexity :   O(k.z)
+// Memory complexity : O(k.z)
+void LineAlternatives::Impl::reduce_all_alternatives(Reduction& result, FullReductionBuffers* buffers)
+{
+    const auto& range_l = m_bidirectional_range;
+    if ((range_l.m_constraint_begin == range_l.m_constraint_end) || (range_l.m_line_begin == range_l.m_line_end))
+        return reduce_no_segment(result);
+
+    copy_line_span(result.reduced_line, m_known_tiles);
+    LineSpanW reduced_line(result.reduced_line);
+    assert(range_l.m_line_begin < range_l.m_line_end);
+    const int line_begin = range_l.m_line_begin;
+    const int k = static_cast<int>(std::distance(range_l.m_constraint_begin, range_l.m_constraint_end));
+    const int m = range_l.m_line_end - line_begin;
+    const int z = static_cast<int>(m_remaining_zeros);
+    const auto width = static_cast<std::size_t>(z + 1);
+    const auto table_size = static_cast<std::size_t>(k + 1) * width;
+    std::unique_ptr<FullReductionBuffers> reduction_buffers;
+    if (!buffers)
+    {
+        reduction_buffers = std::make_unique<FullReductionBuffers>(static_cast<unsigned int>(k), static_cast<unsigned int>(m));
+        buffers = reduction_buffers.get();
+    }
+    assert(buffers);
+    assert(buffers->m_coverage.size() >= static_cast<std::size_t>(m + 1));
+    assert(buffers->m_can_be_empty.size() >= static_cast<std::size_t>(m));
+
+    // Select the tables, and the range of columns to compute
+    auto& tables = m_full_reduction_tables;
+    const bool persistent = table_size <= MAX_PERSISTENT_DP_TABLE_SIZE;
+    const auto constraint_begin = std::distance(m_segments.cbegin(), range_l.m_constraint_begin);
+    const auto constraint_end = std::distance(m_segments.cbegin(), range_l.m_constraint_end);
+    // Full computation by default: first_changed = -1, last_changed = m
+    int first_changed = -1;
+    int last_changed = m;
+    if (persistent && tables.m_valid && tables.m_line_begin == line_begin && tables.m_line_end == range_l.m_line_end
+        && tables.m_constraint_begin == constraint_begin && tables.m_constraint_end == constraint_end)
+    {
+        assert(tables.m_tiles.size() == static_cast<std::size_t>(m));
+        const Tile* known_tiles = m_known_tiles.tiles() + line_begin;
+        first_changed = 0;
+        while (first_changed < m && tables.m_tiles[static_cast<std::size_t>(first_changed)] == known_tiles[first_changed]) { first_changed++; }
+        last_changed = m - 1;
+        while (last_changed > first_changed && tables.m_tiles[static_cast<std::size_t>(last_changed)] == known_tiles[last_changed]) { last_changed--; }
+        if (first_changed == m)
+            last_changed = -1;      // No change
+    }
+    NbAlt* forward = nullptr;
+    NbAlt* backward = nullptr;
+    if (persistent)
+    {
+        tables.m_valid = true;
+        tables.m_line_begin = line_begin;
+        tables.m_line_end = range_l.m_line_end;
+        tables.m_constraint_begin = constraint_begin;
+        tables.m_constraint_end = constraint_end;
+        tables.m_forward.resize(table_size);
+        tables.m_backward.resize(table_size);
+        tables.m_tiles.assign(m_known_tiles.begin() + line_begin, m_known_tiles.begin() + range_l.m_line_end);
+        forward = tables.m_forward.data();
+        backward = tables.m_backward.data();
+    }
+    else
+    {
+        tables.m_valid = false;
+        if (buffers->m_forward.size() < table_size) { buffers->m_forward.resize(table_size); }
+        if (buffers->m_backward.size() < table_size) { buffers->m_backward.resize(table_size); }
+        forward = buffers->m_forward.data();
+        backward = buffers->m_backward.data();
+    }
+
+    // Partial sums of the segment lengths: P(j) = s_0 + ... + s_j-1
+    const auto P = [this, constraint_begin](int j) {
+        return static_cast<int>(m_segments_partial_sums[static_cast<std::size_t>(constraint_begin + j)] - m_segments_partial_sums[static_cast<std::size_t>(constraint_begin)]);
+    };
+    const auto segment = [this, constraint_begin](int j) { return static_cast<int>(m_segments[static_cast<std::size_t>(constraint_begin + j)]); };
+
+    // Windows of the relevant values of x
+    const int total = P(k);
+    const auto lo_F = [&P](int j) { return j == 0 ? 0 : P(j) + j - 1; };
+    const auto hi_F = [&P, k, m, total](int j) { return j == k ? m : m - (total - P(j)) - (k - j); };
+    const auto lo_B = [&P](int j) { return j == 0 ? 0 : P(j) + j; };
+    const auto hi_B = [&P, k, m, total](int j) { return j == k ? m : m - (total - P(j)) - (k - j - 1); };
+    const auto F = [forward, width](int j, int x, int lo) -> NbAlt& { return forward[static_cast<std::size_t>(j) * width + static_cast<std::size_t>(x - lo)]; };
+    const auto B = [backward, width](int j, int x, int lo) -> NbAlt& { return backward[static_cast<std::size_t>(j) * width + static_cast<std::size_t>(x - lo)]; };
+    const auto F_at = [&](int j, int x) -> NbAlt { const int lo = lo_F(j); return (x < lo || x > hi_F(j)) ? NbAlt{0} : F(j, x, lo); };
+    const auto B_at = [&](int j, int x) -> NbAlt { const int lo = lo_B(j); return (x < lo || x > hi_B(j)) ? NbAlt{0} : B(j, x, lo); };
+
+    const Tile* tiles = m_known_tiles.tiles() + line_begin;
+    const auto not_filled = [tiles](int x) { return tiles[x] != Tile::FILLED; };
+    const auto no_empty_tile = [this, line_begin](int begin, int length) {
+        return check_compatibility_bw_filled(line_begin + begin, line_begin + begin + length);
+    };
+
+    // Nb of alternatives of the segments s_0, ..., s_j-1 on the left of a segment starting at index a
+    const auto left_alternatives = [&](int j, int a) -> NbAlt {
+        if (a == 0) { return j == 0 ? NbAlt{1} : NbAlt{0}; }
+        return not_filled(a - 1) ? F_at(j, a - 1) : NbAlt{0};
+    };
+    // Nb of alternatives of the segments s_j, ..., s_k-1 on the right of a segment ending at index e (excluded)
+    const auto right_alternatives = [&](int j, int e) -> NbAlt {
+        if (e == m) { return j == k ? NbAlt{1} : NbAlt{0}; }
+        return not_filled(e) ? B_at(j, e + 1) : NbAlt{0};
+    };
+
+    // Forward sweep, from the column on the right of the first changed tile
+    {
+        for (int j = 0; j <= k; j++)
+        {
+            const int lo = lo_F(j);
+            const int hi = hi_F(j);
+            for (int x = std::max(lo, first_changed + 1); x <= hi; x++)
+            {
+                NbAlt nb_alt = (x >= 1 && not_filled(x - 1)) ? F_at(j, x - 1) : NbAlt{0};
+                if (j == 0 && x == 0)
+                    nb_alt = 1u;
+                if (j > 0)
+                {
+                    const int seg_length = segment(j - 1);
+                    if (x >= seg_length && no_empty_tile(x - seg_length, seg_length))
+                        binomial::add(nb_alt, left_alternatives(j - 1, x - seg_length));
+                }
+                F(j, x, lo) = nb_alt;
+            }
+        }
     }
+
+    // Backward sweep, from the column of the last changed tile
+    {
+        for (int j = k; j >= 0; j--)
+        {
+            const int lo = lo_B(j);
+            const int hi = hi_B(j);
+            for (int x = std::min(hi, last_changed); x >= lo; x--)
+            {
+                NbAlt nb_alt = (x < m && not_filled(x)) ? B_at(j, x + 1) : NbAlt{0};
+                if (j == k && x == m)
+                    nb_alt = 1u;
+                if (j < k)
+                {
+                    const int seg_length = segment(j);
+                    if (x + seg_length <= m && no_empty_tile(x, seg_length))
+                        binomial::add(nb_alt, right_alternatives(j + 1, x + seg_length));
+                }
+                B(j, x, lo) = nb_alt;
+            }
+        }
+    }
+
+    const NbAlt nb_alternatives = B_at(0, 0);
+    assert(nb_alternatives == F_at(k, m));
+    if (nb_alternatives == 0u)
+        return set_result(result, NbAlt{0}, true);
+
+    // Tiles that can be empty
+    char* const can_be_empty = buffers->m_can_be_empty.data();
+    std::fill(can_be_empty, can_be_empty + m, 0);
+    for (int j = 0; j <= k; j++)
+    {
+        const int hi = std::min(hi_F(j), m - 1);
+        for (int x = lo_F(j); x <= hi; x++)
+        {
+            if (!can_be_empty[x] && not_filled(x) && F_at(j, x) > 0u && B_at(j, x + 1) > 0u)
+                can_be_empty[x] = 1;
+        }
+    }
+
+    // Tiles that can be filled: coverage of all the valid segment placements
+    int* const coverage = buffers->m_coverage.data();
+    std::fill(coverage, coverage + m + 1, 0);
+    for (int j = 0; j < k; j++)
+    {
+        const int seg_length = segment(j);
+        const int a_end = hi_F(j + 1) - seg_length;
+        for (int a = lo_B(j); a <= a_end; a++)
+        {
+            if (no_empty_tile(a, seg_length) && left_alternatives(j, a) > 0u && right_alternatives(j + 1, a + seg_length) > 0u)
+            {
+                coverage[a]++;
+                coverage[a + seg_length]--;
+            }
+        }
+    }
+
+    int covered = 0;
+    for (int x = 0; x < m; x++)
+    {
+        covered += coverage[x];
+        const bool can_be_filled = covered > 0;
+        assert(can_be_filled || can_be_empty[x]);
+        auto& tile = reduced_line[line_begin + x];
+        if (can_be_filled != static_cast<bool>(can_be_empty[x]))
+            tile = can_be_filled ? Tile::FILLED : Tile::EMPTY;
+        else
+            tile = Tile::UNKNOWN;
+    }
+
+    return set_result(result, nb_alternatives, true);
 }
 
 
+std::size_t LineAlternatives::Impl::nb_remaining_segments() const
+{
+    const auto& range_l = m_bidirectional_range;
+    if (range_l.m_line_begin == range_l.m_line_end)
+        return 0u;
+    return static_cast<std::size_t>(std::distance(range_l.m_constraint_begin, range_l.m_constraint_end));
+}
+
+void LineAlternatives::Impl::reduce_no_segment(Reduction& result) const
+{
+    const auto& range_l = m_bidirectional_range;
+    copy_line_span(result.reduced_line, m_known_tiles);
+    LineSpanW reduced_line(result.reduced_line);
+    for (int idx = range_l.m_line_begin; idx < range_l.m_line_end; idx++)
+    {
+        reduced_line[idx] = Tile::EMPTY;
+    }
+    const bool match = check_compatibility_bw_empty(range_l.m_line_begin, range_l.m_line_end);
+    return set_result(result, match ? NbAlt{1} : NbAlt{0}, true);
+}
+
+// Full reduction of a line range with one segment s.
+// The segment can be at position a if the tiles [a, a + s) can be filled and all the other tiles can be empty.
+// Time complexity: O(n)
+void LineAlternatives::Impl::reduce_one_segment(Reduction& result) const
+{
+    const auto& range_l = m_bidirectional_range;
+    assert(std::distance(range_l.m_constraint_begin, range_l.m_constraint_end) == 1);
+    const int line_begin = range_l.m_line_begin;
+    const int line_end = range_l.m_line_end;
+    const int seg_length = static_cast<int>(*range_l.m_constraint_begin);
+    assert(line_end - line_begin >= seg_length);
+
+    copy_line_span(result.reduced_line, m_known_tiles);
+    LineSpanW reduced_line(result.reduced_line);
+    for (int idx = line_begin; idx < line_end; idx++) { reduced_line[idx] = Tile::UNKNOWN; }
+
+    NbAlt nb_alternatives = 0u;
+    int min_pos = line_end;
+    int max_pos = -1;
+    int filled_until = line_begin;
+    for (int a = line_begin; a + seg_length <= line_end; a++)
+    {
+        // All the next positions are incompatible if a filled tile is on the left of the segment
+        if (!check_compatibility_bw_empty(line_begin, a))
+            break;
+        if (check_compatibility_bw_filled(a, a + seg_length) && check_compatibility_bw_empty(a + seg_length, line_end))
+        {
+            nb_alternatives++;
+            min_pos = std::min(min_pos, a);
+            max_pos = a;
+            add_possible_value(reduced_line, a, a + seg_length, Tile::FILLED, filled_until);
+        }
+    }
+    if (nb_alternatives == 0u)
+        return set_result(result, m_known_tiles, NbAlt{0}, true);
+
+    for (int idx = line_begin; idx < line_end; idx++)
+    {
+        auto& tile = reduced_line[idx];
+        if (idx < max_pos || idx >= min_pos + seg_length)
+            add_possible_value(tile, Tile::EMPTY);
+        if (tile == TILE_EMPTY_OR_FILLED)
+            tile = Tile::UNKNOWN;
+        assert(tile == Tile::UNKNOWN || m_known_tiles[idx] == Tile::UNKNOWN || tile == m_known_tiles[idx]);
+    }
+    return set_result(result, nb_alternatives, true);
+}
+
+// Full reduction of a line range with two segments s0 and s1.
+// Let valid0(a) (resp. valid1(b)) be true if s0 can be at position a (resp. s1 at position b) regardless of the other segment.
+// A pair (a, b) is an alternative if valid0(a), valid1(b), and the tiles [a + s0, b) can be empty (with b > a + s0).
+// For a given b, the compatible positions a are an interval whose bounds are nondecreasing with b, and vice versa,
+// therefore the nb of alternatives and the positions used by at least one alternative are computed with sliding windows.
+// Time complexity: O(n)
+void LineAlternatives::Impl::reduce_two_segments(Reduction& result) const
+{
+    const auto& range_l = m_bidirectional_range;
+    assert(std::distance(range_l.m_constraint_begin, range_l.m_constraint_end) == 2);
+    const int line_begin = range_l.m_line_begin;
+    const int line_end = range_l.m_line_end;
+    const int seg0 = static_cast<int>(*range_l.m_constraint_begin);
+    const int seg1 = static_cast<int>(*std::next(range_l.m_constraint_begin));
+    const int max_a = line_end - seg1 - seg0 - 1;
+    const int min_b = line_begin + seg0 + 1;
+    const int max_b = line_end - seg1;
+    assert(max_a >= line_begin);
+
+    const auto valid0 = [&](int a) {
+        return check_compatibility_bw_empty(line_begin, a) && check_compatibility_bw_filled(a, a + seg0) && m_known_tiles[a + seg0] != Tile::FILLED;
+    };
+    const auto valid1 = [&](int b) {
+        return m_known_tiles[b - 1] != Tile::FILLED && check_compatibility_bw_filled(b, b + seg1) && check_compatibility_bw_empty(b + seg1, line_end);
+    };
+
+    copy_line_span(result.reduced_line, m_known_tiles);
+    LineSpanW reduced_line(result.reduced_line);
+    for (int idx = line_begin; idx < line_end; idx++) { reduced_line[idx] = Tile::UNKNOWN; }
+
+    // Sweep on the position of s1: count the compatible positions of s0 in the window [lo, b - s0 - 1], where lo - 1 + s0
+    // is the index of the last filled tile before b.
+    NbAlt nb_alternatives = 0u;
+    int min_used_b = line_end;
+    int filled_until = line_begin;
+    {
+        int lo = line_begin;
+        int hi = line_begin - 1;
+        NbAlt nb_valid0 = 0u;
+        for (int b = line_begin + 1; b <= max_b; b++)
+        {
+            for (; hi < b - seg0 - 1; ) { if (valid0(++hi)) { nb_valid0++; } }
+            if (m_known_tiles[b - 1] == Tile::FILLED)
+            {
+                const int new_lo = b - seg0;
+                for (; lo < new_lo; lo++) { if (lo <= hi && valid0(lo)) { nb_valid0--; } }
+            }
+            if (b >= min_b && nb_valid0 > 0u && valid1(b))
+            {
+                binomial::add(nb_alternatives, nb_valid0);
+                min_used_b = std::min(min_used_b, b);
+                add_possible_value(reduced_line, b, b + seg1, Tile::FILLED, filled_until);
+            }
+        }
+    }
+    if (nb_alternatives == 0u)
+        return set_result(result, m_known_tiles, NbAlt{0}, true);
+
+    // Sweep on the position of s0: the compatible positions of s1 are in the window [a + s0 + 1, hi], where hi is bounded
+    // by the first filled tile after the segment s0. The gap between the two segments can be empty up to the last
+    // compatible position of s1 in that window.
+    int max_used_a = -1;
+    {
+        int filled_until_s0 = line_begin;
+        int gap_empty_until = line_begin;
+        int hi = min_b - 1;
+        int last_valid1 = -1;
+        int next_filled = line_begin;
+        for (int a = line_begin; a <= max_a; a++)
+        {
+            if (!check_compatibility_bw_empty(line_begin, a))
+                break;
+            next_filled = std::max(next_filled, a + seg0);
+            while (next_filled < line_end && m_known_tiles[next_filled] != Tile::FILLED) { next_filled++; }
+            const int new_hi = std::min(max_b, next_filled);
+            for (; hi < new_hi; ) { if (valid1(++hi)) { last_valid1 = hi; } }
+            if (last_valid1 >= a + seg0 + 1 && valid0(a))
+            {
+                max_used_a = a;
+                add_possible_value(reduced_line, a, a + seg0, Tile::FILLED, filled_until_s0);
+                add_possible_value(reduced_line, a + seg0, last_valid1, Tile::EMPTY, gap_empty_until);
+            }
+        }
+    }
+    assert(max_used_a >= line_begin);
+
+    for (int idx = line_begin; idx < line_end; idx++)
+    {
+        auto& tile = reduced_line[idx];
+        if (idx < max_used_a || idx >= min_used_b + seg1)
+            add_possible_value(tile, Tile::EMPTY);
+        if (tile == TILE_EMPTY_OR_FILLED)
+            tile = Tile::UNKNOWN;
+        assert(tile == Tile::UNKNOWN || m_known_tiles[idx] == Tile::UNKNOWN || tile == m_known_tiles[idx]);
+    }
+    return set_result(result, nb_alternatives, true);
+}
+
 LineAlternatives::LineAlternatives(const LineConstraint& constraint, const LineSpan& known_tiles, binomial::Cache& binomial)
     : p_impl(std::make_unique<Impl>(constraint, known_tiles, binomial))
 {
@@ -983,51 +1495,103 @@ void LineAlternatives::reset()
 }
 
 LineAlternatives::Reduction LineAlternatives::full_reduction(FullReductionBuffers* buffers)
+{
+    Reduction result = reduction_of_line(p_impl->m_known_tiles);
+    full_reduction(result, buffers);
+    return result;
+}
+
+void LineAlternatives::full_reduction(Reduction& result, FullReductionBuffers* buffers)
 {
     // Update extended copy of known tiles and bidirectional ranges
     bool valid = p_impl->update();
     if (!valid)
-        return from_line(p_impl->m_known_tiles, 0, false);
+        return set_result(result, p_impl->m_known_tiles, 0, false);
+
+    switch (p_impl->nb_remaining_segments())
+    {
+    case 0:
+        return p_impl->reduce_no_segment(result);
+    case 1:
+        return p_impl->reduce_one_segment(result);
+    case 2:
+        return p_impl->reduce_two_segments(result);
+    default:
+        return p_impl->reduce_all_alternatives(result, buffers);
+    }
+}
+
+// Reference implementation for the tests and the benchmark only
+LineAlternatives::Reduction LineAlternatives::full_reduction_recursive()
+{
+    Reduction result = reduction_of_line(p_impl->m_known_tiles);
+    bool valid = p_impl->update();
+    if (!valid)
+    {
+        set_result(result, p_impl->m_known_tiles, 0, false);
+        return result;
+    }
 
-    return p_impl->reduce_all_alternatives(buffers);
+    p_impl->reduce_all_alternatives_recursive(result);
+    return result;
 }
 
-LineAlternatives::Reduction LineAlternatives::linear_reduction()
+LineAlternatives::Reduction LineAlternatives::linear_reduction(std::pmr::memory_resource* memory)
 {
+    Reduction result = reduction_of_line(p_impl->m_known_tiles);
+    linear_reduction(result, memory);
+    return result;
+}
+
+void LineAlternatives::linear_reduction(Reduction& result, std::pmr::memory_resource* memory)
+{
+    if (memory == nullptr)
+        memory = std::pmr::get_default_resource();
     const LineSpan& known_tiles = p_impl->m_known_tiles;
-    const auto invalid_result = [](const LineSpan& line) -> Reduction { return from_line(line, 0, false); };
 
     // Update extended copy of known tiles and bidirectional ranges
     bool valid = p_impl->update();
     if (!valid)
-        return invalid_result(known_tiles);
+        return set_result(result, known_tiles, 0, false);
+
+    // With zero or one segment left, the full reduction is in O(n) as well
+    switch (p_impl->nb_remaining_segments())
+    {
+    case 0:
+        return p_impl->reduce_no_segment(result);
+    case 1:
+        return p_impl->reduce_one_segment(result);
+    default:
+        break;
+    }
 
     // Compute the leftmost and rightmost position of each segment
-    std::vector<SegmentRange> ranges;
-    std::tie(valid, ranges) = local_find_segments_range(known_tiles, p_impl->m_bidirectional_range);
-    if (!valid)
-        return invalid_result(known_tiles);
+    auto [found, ranges] = local_find_segments_range(known_tiles, p_impl->m_bidirectional_range, memory);
+    if (!found)
+        return set_result(result, known_tiles, 0, false);
 
     // Narrow down the leftmost and rightmost ranges
     valid = p_impl->narrow_down_segments_range(ranges);
     if (!valid)
-        return invalid_result(known_tiles);
+        return set_result(result, known_tiles, 0, false);
 
     // Compute the linear reduction
-    return p_impl->linear_reduction(ranges);
+    p_impl->linear_reduction(result, ranges, memory);
 }
 
 // For testing purpose
 std::pair<bool, std::vector<SegmentRange>> LineAlternatives::find_segments_range() const
 {
     BidirectionalRange<false> range(p_impl->m_segments, p_impl->m_line_length);
-    return local_find_segments_range(p_impl->m_known_tiles, range);
+    const auto [success, ranges] = local_find_segments_range(p_impl->m_known_tiles, range, std::pmr::get_default_resource());
+    return std::make_pair(success, std::vector<SegmentRange>(ranges.cbegin(), ranges.cend()));
 }
 
 FullReductionBuffers::FullReductionBuffers(unsigned int max_k, unsigned int max_line_length)
-    : m_line_buffer(Line::ROW, 0, TailReduceArray::reduced_lines_buffer_size(max_k, max_line_length), Tile::UNKNOWN)
-    , m_alts_buffer(max_k * max_line_length, LineAlternatives::NbAlt{0})
-    , m_bool_buffer(max_k * max_line_length, 0)
+    : m_forward((max_k + 1u) * (max_line_length + 1u), LineAlternatives::NbAlt{0})
+    , m_backward((max_k + 1u) * (max_line_length + 1u), LineAlternatives::NbAlt{0})
+    , m_coverage(max_line_length + 1u, 0)
+    , m_can_be_empty(max_line_length, 0)
 {}
 
 } // namespace picross
@@ -11,6 +11,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <ostream>
 #include <vector>
 
@@ -34,6 +35,7 @@ inline bool operator==(const LineHole& lhs, const LineHole& rhs) { return lhs.m_
 std::ostream& operator<<(std::ostream& out, const LineHole& line_hole);
 
 std::vector<LineHole> line_holes(const LineSpan& known_tiles, int line_begin = 0, int line_end = -1);
+std::pmr::vector<LineHole> line_holes(const LineSpan& known_tiles, int line_begin, int line_end, std::pmr::memory_resource* memory);
 
 struct SegmentRange
 {
@@ -45,11 +47,11 @@ std::ostream& operator<<(std::ostream& out, const SegmentRange& segment_range);
 
 struct FullReductionBuffers;
 
-// Given a constraint, recursively build the possible alternatives of a Line and reduce them.
+// Given a constraint, build the possible alternatives of a Line and reduce them.
 class LineAlternatives
 {
 public:
-    using NbAlt = std::uint32_t;
+    using NbAlt = std::uint64_t;
 public:
     LineAlternatives(const LineConstraint& constraint, const LineSpan& known_tiles, binomial::Cache& binomial);
     LineAlternatives(const LineAlternatives& other, const LineSpan& known_tiles);
@@ -70,25 +72,40 @@ public:
         NbAlt nb_alternatives = 0;
         bool is_fully_reduced = false;
     };
+    // The temporary buffers of the linear reduction are allocated from memory, or from the default memory resource if null
     Reduction full_reduction(FullReductionBuffers* buffers = nullptr);
-    Reduction linear_reduction();
+    Reduction linear_reduction(std::pmr::memory_resource* memory = nullptr);
+
+    // Same as above, but the reduction is written in result, which must have been built by reduction_of_line() with
+    // the same line. The tiles of its reduced line are overwritten, and no memory is allocated for it.
+    void full_reduction(Reduction& result, FullReductionBuffers* buffers);
+    void linear_reduction(Reduction& result, std::pmr::memory_resource* memory);
 
     // For test purpose only
     std::pair<bool, std::vector<SegmentRange>> find_segments_range() const;
 
+    // The previous implementation of the full reduction, recursive and in O(k.n^3). The solver does not use it: its only
+    // purpose is to be the reference of the unit tests and the benchmark of the dynamic programming implementation.
+    Reduction full_reduction_recursive();
+
 private:
     struct Impl;
     std::unique_ptr<Impl> p_impl;
 };
 
+// A reduction result with a reduced line of the same type, index and size as line
+LineAlternatives::Reduction reduction_of_line(const LineSpan& line);
+
+// Memory buffers used by the full reduction, in O(k.n)
 struct FullReductionBuffers
 {
     // K: max nb of segments of ones on a line
     FullReductionBuffers(unsigned int max_k, unsigned int max_line_length);
 
-    Line                                    m_line_buffer;
-    std::vector<LineAlternatives::NbAlt>    m_alts_buffer;
-    std::vector<char>                       m_bool_buffer;
+    std::vector<LineAlternatives::NbAlt>    m_forward;          // DP tables of the lines that are too large to be kept between two reductions
+    std::vector<LineAlternatives::NbAlt>    m_backward;
+    std::vector<int>                        m_coverage;
+    std::vector<char>                       m_can_be_empty;
 };
 
 } // namespace picross
@@ -0,0 +1,234 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "line_automaton.h"
+
+#include "binomial.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace picross {
+
+namespace {
+    using Word = LineAutomaton::Word;
+    constexpr std::size_t WORD_BITS = LineAutomaton::WORD_BITS;
+
+    void set_bit(std::vector<Word>& bits, std::size_t idx)
+    {
+        bits[idx / WORD_BITS] |= Word{1} << (idx % WORD_BITS);
+    }
+
+    bool test_bit(const Word* bits, std::size_t idx)
+    {
+        return ((bits[idx / WORD_BITS] >> (idx % WORD_BITS)) & 1u) != 0u;
+    }
+
+    bool intersect(const Word* lhs, const Word* rhs, std::size_t nb_words)
+    {
+        Word acc = 0u;
+        for (std::size_t w = 0u; w < nb_words; w++)
+            acc |= lhs[w] & rhs[w];
+        return acc != 0u;
+    }
+
+    // (x & mask) << 1, on a multi-word bitset
+    Word shift_left(const Word* x, const Word* mask, std::size_t w)
+    {
+        const Word carry = w > 0u ? (x[w - 1u] & mask[w - 1u]) >> (WORD_BITS - 1u) : Word{0};
+        return ((x[w] & mask[w]) << 1) | carry;
+    }
+
+    // x >> 1, on a multi-word bitset
+    Word shift_right(const Word* x, std::size_t w, std::size_t nb_words)
+    {
+        const Word carry = w + 1u < nb_words ? x[w + 1u] << (WORD_BITS - 1u) : Word{0};
+        return (x[w] >> 1) | carry;
+    }
+
+    template <typename F>
+    void for_each_bit(const Word* bits, std::size_t nb_words, F f)
+    {
+        for (std::size_t w = 0u; w < nb_words; w++)
+        {
+            for (Word word = bits[w]; word != 0u; word &= word - 1u)
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                const auto bit = static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+                std::size_t bit = 0u;
+                while (((word >> bit) & 1u) == 0u) { bit++; }
+#endif
+                f(w * WORD_BITS + bit);
+            }
+        }
+    }
+} // namespace
+
+
+LineAutomaton::LineAutomaton(const LineConstraint& constraint)
+    : m_nb_states(1u + constraint.nb_filled_tiles() + constraint.nb_segments())
+    , m_nb_words((m_nb_states + WORD_BITS - 1u) / WORD_BITS)
+    , m_empty_loop(m_nb_words, Word{0})
+    , m_segment_end(m_nb_words, Word{0})
+    , m_advance(m_nb_words, Word{0})
+    , m_accept(m_nb_words, Word{0})
+{
+    std::size_t state = 0u;
+    for (const auto segment : constraint.segments())
+    {
+        assert(segment > 0u);
+        set_bit(m_empty_loop, state);
+        for (unsigned int i = 0u; i < segment; i++)
+            set_bit(m_advance, state++);
+        set_bit(m_segment_end, state);
+        state++;
+    }
+    // Last E state
+    set_bit(m_empty_loop, state);
+    set_bit(m_accept, state);
+    if (state > 0u)
+        set_bit(m_accept, state - 1u);
+    assert(state + 1u == m_nb_states);
+}
+
+
+LineAlternatives::Reduction LineAutomaton::full_reduction(const LineSpan& known_tiles, Buffers& buffers, bool count_alternatives) const
+{
+    LineAlternatives::Reduction result = reduction_of_line(known_tiles);
+    full_reduction(result, known_tiles, buffers, count_alternatives);
+    return result;
+}
+
+
+void LineAutomaton::full_reduction(LineAlternatives::Reduction& result, const LineSpan& known_tiles, Buffers& buffers, bool count_alternatives) const
+{
+    assert(result.reduced_line.type() == known_tiles.type());
+    assert(result.reduced_line.index() == known_tiles.index());
+    assert(result.reduced_line.size() == known_tiles.size());
+    if (m_nb_words == 1u)
+        full_reduction_impl<true>(result, known_tiles, buffers, count_alternatives);
+    else
+        full_reduction_impl<false>(result, known_tiles, buffers, count_alternatives);
+}
+
+
+template <bool SingleWord>
+void LineAutomaton::full_reduction_impl(LineAlternatives::Reduction& result, const LineSpan& known_tiles, Buffers& buffers, bool count_alternatives) const
+{
+    const std::size_t nb_words = SingleWord ? 1u : m_nb_words;
+    const std::size_t line_size = known_tiles.size();
+    const Tile* tiles = known_tiles.tiles();
+    const Word* empty_loop = m_empty_loop.data();
+    const Word* segment_end = m_segment_end.data();
+    const Word* advance = m_advance.data();
+
+    result.is_fully_reduced = true;
+
+    const std::size_t table_size = (line_size + 1u) * nb_words;
+    if (buffers.m_forward.size() < table_size) { buffers.m_forward.resize(table_size); }
+
+    // Forward sweep: states reachable after the tiles [0, x)
+    Word* forward = buffers.m_forward.data();
+    std::fill(forward, forward + nb_words, Word{0});
+    forward[0] = Word{1};
+    for (std::size_t x = 0u; x < line_size; x++)
+    {
+        const Word* in = forward + x * nb_words;
+        Word* out = forward + (x + 1u) * nb_words;
+        const Word empty_mask = tiles[x] != Tile::FILLED ? ~Word{0} : Word{0};
+        const Word filled_mask = tiles[x] != Tile::EMPTY ? ~Word{0} : Word{0};
+        for (std::size_t w = 0u; w < nb_words; w++)
+        {
+            const Word on_empty = (in[w] & empty_loop[w]) | shift_left(in, segment_end, w);
+            const Word on_filled = shift_left(in, advance, w);
+            out[w] = (on_empty & empty_mask) | (on_filled & filled_mask);
+        }
+    }
+    if (!intersect(forward + line_size * nb_words, m_accept.data(), nb_words))
+    {
+        std::copy(known_tiles.begin(), known_tiles.end(), result.reduced_line.begin());
+        result.nb_alternatives = 0u;
+        return;
+    }
+
+    // Backward sweep: states from which an accepting state is reachable with the tiles [x, n)
+    // The tile x can be empty (resp. filled) if one of the states reached after [0, x) leads to such a state on an empty
+    // (resp. filled) tile.
+    // Without the count, only two columns of the backward table are kept
+    const std::size_t backward_size = count_alternatives ? table_size : 2u * nb_words;
+    if (buffers.m_backward.size() < backward_size) { buffers.m_backward.resize(backward_size); }
+    Word* backward = buffers.m_backward.data();
+    const auto backward_at = [backward, nb_words, count_alternatives](std::size_t x) -> Word* {
+        return backward + (count_alternatives ? x : x % 2u) * nb_words;
+    };
+    std::copy(m_accept.cbegin(), m_accept.cend(), backward_at(line_size));
+    for (std::size_t x = line_size; x-- > 0u;)
+    {
+        const Word* in = backward_at(x + 1u);
+        Word* out = backward_at(x);
+        const Word* reached = forward + x * nb_words;
+        const bool empty_allowed = tiles[x] != Tile::FILLED;
+        const bool filled_allowed = tiles[x] != Tile::EMPTY;
+        Word can_be_empty = 0u;
+        Word can_be_filled = 0u;
+        for (std::size_t w = 0u; w < nb_words; w++)
+        {
+            const Word next = shift_right(in, w, nb_words);
+            const Word from_empty = (in[w] & empty_loop[w]) | (next & segment_end[w]);
+            const Word from_filled = next & advance[w];
+            can_be_empty |= from_empty & reached[w];
+            can_be_filled |= from_filled & reached[w];
+            out[w] = (empty_allowed ? from_empty : Word{0}) | (filled_allowed ? from_filled : Word{0});
+        }
+        const bool empty = empty_allowed && can_be_empty != 0u;
+        const bool filled = filled_allowed && can_be_filled != 0u;
+        assert(empty || filled);
+        result.reduced_line[x] = empty == filled ? Tile::UNKNOWN : (filled ? Tile::FILLED : Tile::EMPTY);
+    }
+
+    if (!count_alternatives)
+    {
+        result.nb_alternatives = 1u;
+        return;
+    }
+
+    // Count the paths of the automaton through the live states, that is the states reachable from the start which lead to
+    // an accepting state
+    if (buffers.m_counts.size() < 2u * m_nb_states) { buffers.m_counts.resize(2u * m_nb_states); }
+    if (buffers.m_live.size() < nb_words) { buffers.m_live.resize(nb_words); }
+    NbAlt* counts[2] = { buffers.m_counts.data(), buffers.m_counts.data() + m_nb_states };
+    Word* live = buffers.m_live.data();
+    const auto load_live = [forward, backward, live, nb_words](std::size_t x) {
+        for (std::size_t w = 0u; w < nb_words; w++)
+            live[w] = forward[x * nb_words + w] & backward[x * nb_words + w];
+    };
+    counts[0][0] = 1u;
+    for (std::size_t x = 0u; x < line_size; x++)
+    {
+        NbAlt* const current = counts[x % 2u];
+        NbAlt* const next = counts[(x + 1u) % 2u];
+        // Only the counts of the live states are reset, the other ones are never read
+        load_live(x + 1u);
+        for_each_bit(live, nb_words, [next](std::size_t state) { next[state] = 0u; });
+        const bool empty_allowed = tiles[x] != Tile::FILLED;
+        const bool filled_allowed = tiles[x] != Tile::EMPTY;
+        load_live(x);
+        for_each_bit(live, nb_words, [&](std::size_t state) {
+            const NbAlt nb_alt = current[state];
+            if (empty_allowed && test_bit(empty_loop, state))
+                binomial::add(next[state], nb_alt);
+            if ((empty_allowed && test_bit(segment_end, state)) || (filled_allowed && test_bit(advance, state)))
+                binomial::add(next[state + 1u], nb_alt);
+        });
+    }
+    NbAlt nb_alternatives = 0u;
+    load_live(line_size);
+    for_each_bit(live, nb_words, [&](std::size_t state) { binomial::add(nb_alternatives, counts[line_size % 2u][state]); });
+    assert(nb_alternatives > 0u);
+    result.nb_alternatives = nb_alternatives;
+}
+
+} // namespace picross
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Declaration of the PRIVATE API of the Picross solver
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include "line_alternatives.h"
+#include "line_constraint.h"
+#include "line_span.h"
+
+#include <picross/picross.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace picross {
+
+/*
+ * LineAutomaton class
+ *
+ *   A line constraint compiled into a position automaton, with one state per tile of the pattern:
+ *
+ *      E_0 F_0,0 ... F_0,s0-1 E_1 F_1,0 ... E_k
+ *
+ *   The E states loop on empty tiles, the F states are the filled tiles of each segment. The set of active states is
+ *   a bitset: one transition of the automaton is a few shifts and masks on machine words ("shift-and"). Lines with
+ *   up to 62 tiles are processed with a single word per bitset.
+ *
+ *   The full reduction of a line is one forward and one backward sweep over the line, which is an alternative to the
+ *   dynamic programming of LineAlternatives::full_reduction(). The number of alternatives is computed on demand.
+ */
+class LineAutomaton
+{
+public:
+    using Word = std::uint64_t;
+    using NbAlt = LineAlternatives::NbAlt;
+    static constexpr std::size_t WORD_BITS = 64u;
+
+    // Memory buffers used by the reduction, they can be shared by all the automata
+    struct Buffers
+    {
+        std::vector<Word>   m_forward;
+        std::vector<Word>   m_backward;
+        std::vector<NbAlt>  m_counts;
+        std::vector<Word>   m_live;
+    };
+
+public:
+    explicit LineAutomaton(const LineConstraint& constraint);
+
+    std::size_t nb_states() const { return m_nb_states; }
+    std::size_t nb_words() const { return m_nb_words; }
+
+    // Same result as LineAlternatives::full_reduction(). If count_alternatives is false, the number of alternatives is
+    // not computed: nb_alternatives is 0 if the line is contradictory, 1 otherwise.
+    LineAlternatives::Reduction full_reduction(const LineSpan& known_tiles, Buffers& buffers, bool count_alternatives = true) const;
+
+    // Same as above, the reduction is written in result, which must have been built by reduction_of_line(known_tiles)
+    void full_reduction(LineAlternatives::Reduction& result, const LineSpan& known_tiles, Buffers& buffers, bool count_alternatives = true) const;
+
+private:
+    template <bool SingleWord>
+    void full_reduction_impl(LineAlternatives::Reduction& result, const LineSpan& known_tiles, Buffers& buffers, bool count_alternatives) const;
+
+private:
+    std::size_t         m_nb_states;
+    std::size_t         m_nb_words;
+    std::vector<Word>   m_empty_loop;       // States E_j: stay on an empty tile
+    std::vector<Word>   m_segment_end;      // States F_j,sj-1: move to E_j+1 on an empty tile
+    std::vector<Word>   m_advance;          // States E_j (j < k) and F_j,i (i < sj-1): move to the next state on a filled tile
+    std::vector<Word>   m_accept;           // States E_k and F_k-1,sk-1-1
+};
+
+} // namespace picross
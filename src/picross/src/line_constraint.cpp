@@ -45,7 +45,7 @@ unsigned int LineConstraint::max_segment_size() const
 }
 
 // Given an uninitialized line compute the theoritical number of alternatives
-unsigned int LineConstraint::line_trivial_nb_alternatives(unsigned int line_size, binomial::Cache& binomial_cache) const
+binomial::Rep LineConstraint::line_trivial_nb_alternatives(unsigned int line_size, binomial::Cache& binomial_cache) const
 {
     if (line_size < m_min_line_size)
     {
@@ -196,6 +196,143 @@ std::vector<Line> LineConstraint::build_all_possible_lines(const LineSpan& known
     return result;
 }
 
+AlternativesEnumerator::AlternativesEnumerator(const LineConstraint& constraint, const LineSpan& known_tiles)
+    : m_segments(constraint.segments())
+    , m_line_size(static_cast<unsigned int>(known_tiles.size()))
+    , m_max_start(m_segments.size(), 0u)
+    , m_start(m_segments.size(), 0u)
+    , m_nb_filled_before(known_tiles.size() + 1u, 0u)
+    , m_nb_empty_before(known_tiles.size() + 1u, 0u)
+    , m_current(known_tiles.type(), known_tiles.index(), known_tiles.size(), Tile::UNKNOWN)
+    , m_started(false)
+    , m_done(false)
+{
+    assert(m_line_size >= constraint.min_line_size());
+    unsigned int suffix_size = 0u;
+    for (std::size_t seg_idx = m_segments.size(); seg_idx-- > 0u;)
+    {
+        suffix_size += m_segments[seg_idx] + (suffix_size > 0u ? 1u : 0u);
+        m_max_start[seg_idx] = m_line_size - suffix_size;
+    }
+    reset(known_tiles);
+}
+
+void AlternativesEnumerator::reset(const LineSpan& known_tiles)
+{
+    assert(known_tiles.type() == m_current.type());
+    assert(known_tiles.index() == m_current.index());
+    assert(known_tiles.size() == m_line_size);
+    for (unsigned int idx = 0u; idx < m_line_size; idx++)
+    {
+        const Tile tile = known_tiles[static_cast<int>(idx)];
+        m_nb_filled_before[idx + 1u] = m_nb_filled_before[idx] + (tile == Tile::FILLED ? 1u : 0u);
+        m_nb_empty_before[idx + 1u] = m_nb_empty_before[idx] + (tile == Tile::EMPTY ? 1u : 0u);
+    }
+    m_started = false;
+    m_done = false;
+}
+
+unsigned int AlternativesEnumerator::nb_filled(unsigned int begin, unsigned int end) const
+{
+    return m_nb_filled_before[end] - m_nb_filled_before[begin];
+}
+
+unsigned int AlternativesEnumerator::nb_empty(unsigned int begin, unsigned int end) const
+{
+    return m_nb_empty_before[end] - m_nb_empty_before[begin];
+}
+
+// Index of the first tile that can be used by the segment seg_idx, given the position of the previous segments
+unsigned int AlternativesEnumerator::segments_begin(std::size_t seg_idx) const
+{
+    return seg_idx == 0u ? 0u : m_start[seg_idx - 1u] + m_segments[seg_idx - 1u] + 1u;
+}
+
+// Find the first position of the segment seg_idx, starting at index start, that is compatible with the known tiles
+// on the left of the segment end (and on the right of it if this is the last segment).
+bool AlternativesEnumerator::place_segment(std::size_t seg_idx, unsigned int start)
+{
+    const unsigned int gap_begin = segments_begin(seg_idx);
+    const unsigned int seg_length = m_segments[seg_idx];
+    const bool last = seg_idx + 1u == m_segments.size();
+    for (; start <= m_max_start[seg_idx]; start++)
+    {
+        // If a filled tile is in the gap before the segment, all the next positions are also incompatible
+        if (nb_filled(gap_begin, start) > 0u)
+            return false;
+        const unsigned int end = start + seg_length;
+        if (nb_empty(start, end) > 0u)
+            continue;
+        if (last ? nb_filled(end, m_line_size) > 0u : nb_filled(end, end + 1u) > 0u)
+            continue;
+        m_start[seg_idx] = start;
+        return true;
+    }
+    return false;
+}
+
+void AlternativesEnumerator::write_current()
+{
+    unsigned int line_idx = 0u;
+    for (std::size_t seg_idx = 0u; seg_idx < m_segments.size(); seg_idx++)
+    {
+        while (line_idx < m_start[seg_idx]) { m_current[line_idx++] = Tile::EMPTY; }
+        for (unsigned int c = 0u; c < m_segments[seg_idx]; c++) { m_current[line_idx++] = Tile::FILLED; }
+    }
+    while (line_idx < m_line_size) { m_current[line_idx++] = Tile::EMPTY; }
+}
+
+bool AlternativesEnumerator::next()
+{
+    if (m_done)
+        return false;
+
+    const std::size_t k = m_segments.size();
+    if (k == 0u)
+    {
+        // Only one alternative, the all-zero line
+        m_done = true;
+        if (nb_filled(0u, m_line_size) > 0u)
+            return false;
+        write_current();
+        return true;
+    }
+
+    // Depth-first search on the position of the segments. The search resumes at the position following the current
+    // alternative: the segments are moved rightward starting from the last one, in the order of build_all_possible_lines()
+    std::size_t seg_idx = 0u;
+    unsigned int start = 0u;
+    if (m_started)
+    {
+        seg_idx = k - 1u;
+        start = m_start[seg_idx] + 1u;
+    }
+    m_started = true;
+    while (true)
+    {
+        if (place_segment(seg_idx, start))
+        {
+            if (seg_idx + 1u == k)
+            {
+                write_current();
+                return true;
+            }
+            seg_idx++;
+            start = segments_begin(seg_idx);
+        }
+        else
+        {
+            if (seg_idx == 0u)
+            {
+                m_done = true;
+                return false;
+            }
+            seg_idx--;
+            start = m_start[seg_idx] + 1u;
+        }
+    }
+}
+
 bool LineConstraint::compatible(const LineSpan& line) const
 {
     assert(line.is_completed());
@@ -53,9 +53,9 @@ public:
     std::size_t nb_segments() const { return m_segments.size(); }
     const Segments& segments() const { return m_segments; }
     unsigned int min_line_size() const { return m_min_line_size; }
-    unsigned int line_trivial_nb_alternatives(unsigned int line_size, binomial::Cache& binomial) const;
+    binomial::Rep line_trivial_nb_alternatives(unsigned int line_size, binomial::Cache& binomial) const;
     Line line_trivial_reduction(unsigned int line_size, unsigned int index) const;
-    std::vector<Line> build_all_possible_lines(const LineSpan& known_tiles) const;
+    std::vector<Line> build_all_possible_lines(const LineSpan& known_tiles) const;     // See also AlternativesEnumerator
     bool compatible(const LineSpan& line) const;
 private:
     unsigned int max_segment_size() const;
@@ -67,4 +67,46 @@ private:
     unsigned int        m_min_line_size;            // Minimal line size compatible with this constraint
 };
 
+/*
+ * AlternativesEnumerator class
+ *
+ *   Enumerate, one at a time, the alternatives of a line constraint that are compatible with the known tiles.
+ *   Same alternatives and same order as LineConstraint::build_all_possible_lines(), but the current alternative
+ *   is written in a buffer that is reused from one alternative to the next. Memory complexity: O(n)
+ *
+ *   Usage:
+ *      AlternativesEnumerator enumerator(constraint, known_tiles);
+ *      while (enumerator.next()) { const Line& alternative = enumerator.current(); ... }
+ */
+class AlternativesEnumerator
+{
+public:
+    AlternativesEnumerator(const LineConstraint& constraint, const LineSpan& known_tiles);
+
+    // Restart the enumeration with other known tiles on the same line, without allocating
+    void reset(const LineSpan& known_tiles);
+
+    // Compute the next alternative. Return false if there are no more alternatives.
+    bool next();
+    const Line& current() const { return m_current; }
+
+private:
+    unsigned int nb_filled(unsigned int begin, unsigned int end) const;
+    unsigned int nb_empty(unsigned int begin, unsigned int end) const;
+    unsigned int segments_begin(std::size_t seg_idx) const;
+    bool place_segment(std::size_t seg_idx, unsigned int start);
+    void write_current();
+
+private:
+    const Segments&             m_segments;
+    const unsigned int          m_line_size;
+    std::vector<unsigned int>   m_max_start;            // Max start index of each segment
+    std::vector<unsigned int>   m_start;                // Start index of each segment in the current alternative
+    std::vector<unsigned int>   m_nb_filled_before;     // Prefix counts of the known tiles
+    std::vector<unsigned int>   m_nb_empty_before;
+    Line                        m_current;
+    bool                        m_started;
+    bool                        m_done;
+};
+
 } // namespace picross
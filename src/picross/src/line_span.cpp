@@ -5,6 +5,8 @@
  ******************************************************************************/
 #include "line_span.h"
 
+#include "tile_bits.h"
+
 #include <algorithm>
 #include <cassert>
 #include <sstream>
@@ -22,24 +24,6 @@ namespace Tiles {
         oss << "Invalid tile value: " << static_cast<int>(t);
         throw std::invalid_argument(oss.str());
     }
-
-    inline Tile add(Tile t1, Tile t2)
-    {
-        if (t1 == t2 || t2 == Tile::UNKNOWN) { return t1; }
-        else { assert(t1 == Tile::UNKNOWN); return t2; }
-    }
-
-    inline Tile delta(Tile t1, Tile t2)
-    {
-        if (t1 == t2) { return Tile::UNKNOWN; }
-        else { assert(t2 == Tile::UNKNOWN); return t1; }
-    }
-
-    inline Tile reduce(Tile t1, Tile t2)
-    {
-        if (t1 == t2) { return t1; }
-        return Tile::UNKNOWN;
-    }
 } // namespace Tiles
 } // namespace
 
@@ -64,14 +48,7 @@ bool are_compatible(const LineSpan& lhs, const LineSpan& rhs)
         return false;
     if (lhs.size() != rhs.size())
         return false;
-    for (size_t idx = 0u; idx < lhs.size(); ++idx)
-    {
-        const auto& l_tile = lhs.tiles()[idx];
-        const auto& r_tile = rhs.tiles()[idx];
-        if (l_tile != Tile::UNKNOWN && r_tile != Tile::UNKNOWN && l_tile != r_tile)
-            return false;
-    }
-    return true;
+    return tile_bits::are_compatible(lhs.tiles(), rhs.tiles(), lhs.size());
 }
 
 std::ostream& operator<<(std::ostream& out, const LineSpan& line)
@@ -92,7 +69,7 @@ std::ostream& operator<<(std::ostream& out, const LineSpan& line)
 LineSpanW& operator+=(LineSpanW& lhs, const LineSpan& rhs)
 {
     assert(are_compatible(LineSpan(lhs), LineSpan(rhs)));
-    std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), Tiles::add);
+    tile_bits::add(lhs.tiles(), rhs.tiles(), lhs.size());
     return lhs;
 }
 
@@ -106,7 +83,7 @@ LineSpanW& operator+=(LineSpanW& lhs, const LineSpan& rhs)
 LineSpanW& operator-=(LineSpanW& lhs, const LineSpan& rhs)
 {
     assert(are_compatible(LineSpan(lhs), LineSpan(rhs)));
-    std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), Tiles::delta);
+    tile_bits::delta(lhs.tiles(), rhs.tiles(), lhs.size());
     return lhs;
 }
 
@@ -122,7 +99,7 @@ LineSpanW& line_reduce(LineSpanW& lhs, const LineSpan& rhs)
     assert(lhs.type() == rhs.type());
     assert(lhs.index() == rhs.index());
     assert(lhs.size() == rhs.size());
-    std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), Tiles::reduce);
+    tile_bits::reduce(lhs.tiles(), rhs.tiles(), lhs.size());
     return lhs;
 }
 
@@ -5,6 +5,8 @@
  ******************************************************************************/
 #pragma once
 
+#include "tile_bits.h"
+
 #include <picross/picross.h>
 
 #include <algorithm>
@@ -57,7 +59,7 @@ public:
 
     bool is_completed() const
     {
-        return std::none_of(begin(), end(), [](const Tile t) { return t == Tile::UNKNOWN; });
+        return tile_bits::is_completed(m_tiles, m_size);
     }
 
     LineSpanImpl head(int idx) const
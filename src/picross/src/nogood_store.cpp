@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "nogood_store.h"
+
+namespace picross {
+
+namespace {
+    constexpr std::size_t NB_BUCKETS = 1u << 14;
+} // namespace
+
+NogoodStore::NogoodStore(std::size_t max_nb_decisions)
+    : m_max_nb_decisions(max_nb_decisions)
+    , m_decisions()
+    , m_nogoods()
+    , m_heads()
+    , m_watches()
+{
+}
+
+std::uint64_t NogoodStore::line_hash(const LineSpan& line)
+{
+    // FNV-1a
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (const Tile tile : line)
+    {
+        hash ^= static_cast<std::uint64_t>(tile);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::size_t NogoodStore::bucket_index(const LineId& line_id, std::uint64_t hash) const
+{
+    const std::uint64_t line_key = (static_cast<std::uint64_t>(line_id.m_index) << 1) | (line_id.m_type == Line::ROW ? 0u : 1u);
+    return static_cast<std::size_t>(((hash ^ line_key) * 0x9e3779b97f4a7c15ull) >> 32) & (NB_BUCKETS - 1u);
+}
+
+bool NogoodStore::add(const Decisions& nogood)
+{
+    if (nogood.empty() || m_decisions.size() + nogood.size() > m_max_nb_decisions)
+        return false;
+    if (m_heads.empty())
+        m_heads.resize(NB_BUCKETS, 0u);
+
+    const auto nogood_idx = static_cast<std::uint32_t>(m_nogoods.size());
+    m_nogoods.push_back(Nogood{ static_cast<std::uint32_t>(m_decisions.size()), static_cast<std::uint32_t>(nogood.size()) });
+    for (const Decision& decision : nogood)
+    {
+        m_decisions.push_back(decision);
+        std::uint32_t& head = m_heads[bucket_index(decision.m_line_id, decision.m_hash)];
+        m_watches.push_back(Watch{ decision.m_line_id, decision.m_hash, nogood_idx, head });
+        head = static_cast<std::uint32_t>(m_watches.size());
+    }
+    return true;
+}
+
+} // namespace picross
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Nogoods learned by the branch search, shared by the nested work grids
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include <picross/picross.h>
+
+#include "line_span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace picross {
+
+/*
+ * NogoodStore class
+ *
+ *   A nogood is a combination of complete lines that was found to be contradictory: any grid in which all those lines are
+ *   set to the same tiles is contradictory as well. The lines are the hypotheses of the branch search on which a
+ *   contradiction depended, and they are identified by the hash of their tiles.
+ *   A nogood is listed under each of its lines, in a hash table keyed by the line and the hash of its tiles, so that it is
+ *   checked when the search makes the same hypothesis on one of them.
+ *   The number of stored lines is bounded, and the memory of the store is only allocated when the first nogood is added.
+ */
+class NogoodStore
+{
+public:
+    struct Decision
+    {
+        LineId          m_line_id;
+        std::uint64_t   m_hash;             // Of the tiles of the line, see line_hash()
+    };
+    using Decisions = std::vector<Decision>;
+
+public:
+    explicit NogoodStore(std::size_t max_nb_decisions);
+
+    static std::uint64_t line_hash(const LineSpan& line);
+
+    // Return false if the nogood was not stored, because the store is full
+    bool add(const Decisions& nogood);
+
+    // Call f on the lines of each of the nogoods that involve the line set to the tiles of that hash, as a pair of pointers,
+    // until f returns true. Return true in that case.
+    template <typename F>
+    bool find(const LineId& line_id, std::uint64_t hash, F&& f) const;
+
+    std::size_t nb_nogoods() const { return m_nogoods.size(); }
+
+private:
+    struct Nogood
+    {
+        std::uint32_t   m_begin;            // In m_decisions
+        std::uint32_t   m_size;
+    };
+    struct Watch
+    {
+        LineId          m_line_id;
+        std::uint64_t   m_hash;             // Of the tiles of the watched line
+        std::uint32_t   m_nogood;
+        std::uint32_t   m_next;             // Index of the next watch of the same bucket, plus one. Zero at the end of the list.
+    };
+
+    std::size_t bucket_index(const LineId& line_id, std::uint64_t hash) const;
+
+private:
+    std::size_t                 m_max_nb_decisions;
+    std::vector<Decision>       m_decisions;
+    std::vector<Nogood>         m_nogoods;
+    std::vector<std::uint32_t>  m_heads;        // Indexed by the bucket. Index of its first watch, plus one
+    std::vector<Watch>          m_watches;
+};
+
+template <typename F>
+bool NogoodStore::find(const LineId& line_id, std::uint64_t hash, F&& f) const
+{
+    if (m_heads.empty())
+        return false;
+    for (std::uint32_t next = m_heads[bucket_index(line_id, hash)]; next != 0u; next = m_watches[next - 1u].m_next)
+    {
+        const Watch& watch = m_watches[next - 1u];
+        if (watch.m_hash != hash || watch.m_line_id.m_type != line_id.m_type || watch.m_line_id.m_index != line_id.m_index)
+            continue;
+        const Nogood& nogood = m_nogoods[watch.m_nogood];
+        const Decision* begin = m_decisions.data() + nogood.m_begin;
+        if (f(begin, begin + nogood.m_size))
+            return true;
+    }
+    return false;
+}
+
+} // namespace picross
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <utility>
 
 namespace picross {
 
@@ -19,10 +20,20 @@ DifficultyCode difficulty_code(const GridStats& grid_stats)
     return difficulty_code(grid_stats.nb_solutions, grid_stats.max_branching_depth);
 }
 
+void reset_grid_stats(GridStats& stats)
+{
+    auto max_nb_alternatives_by_branching_depth = std::move(stats.max_nb_alternatives_by_branching_depth);
+    max_nb_alternatives_by_branching_depth.clear();
+    stats = GridStats();
+    stats.max_nb_alternatives_by_branching_depth = std::move(max_nb_alternatives_by_branching_depth);
+}
+
 void merge_branching_grid_stats(GridStats& stats, const GridStats& branching_stats)
 {
     stats.nb_solutions += branching_stats.nb_solutions;
     stats.max_branching_depth = std::max(stats.max_branching_depth, branching_stats.max_branching_depth);
+    // In the parallel search, the alternatives of a branching grid may all have been solved by the other workers
+    stats.max_branching_depth = std::max(stats.max_branching_depth, static_cast<unsigned int>(branching_stats.max_nb_alternatives_by_branching_depth.size()));
     stats.nb_branching_calls += branching_stats.nb_branching_calls;
     stats.total_nb_branching_alternatives += branching_stats.total_nb_branching_alternatives;
     stats.nb_probing_calls += branching_stats.nb_probing_calls;
@@ -52,6 +63,18 @@ void merge_branching_grid_stats(GridStats& stats, const GridStats& branching_sta
     stats.nb_single_line_linear_reduction_w_change += branching_stats.nb_single_line_linear_reduction_w_change;
     stats.nb_single_line_full_reduction += branching_stats.nb_single_line_full_reduction;
     stats.nb_single_line_full_reduction_w_change += branching_stats.nb_single_line_full_reduction_w_change;
+    stats.nb_reduction_cache_hits += branching_stats.nb_reduction_cache_hits;
+    stats.nb_reduction_cache_misses += branching_stats.nb_reduction_cache_misses;
+    stats.nb_stolen_branching_alternatives += branching_stats.nb_stolen_branching_alternatives;
+    stats.nb_cell_probing_calls += branching_stats.nb_cell_probing_calls;
+    stats.nb_implications = std::max(stats.nb_implications, branching_stats.nb_implications);
+    stats.nb_implied_tiles += branching_stats.nb_implied_tiles;
+    stats.nb_backjumps += branching_stats.nb_backjumps;
+    stats.nb_backjump_skipped_alternatives += branching_stats.nb_backjump_skipped_alternatives;
+    stats.nb_nogoods += branching_stats.nb_nogoods;
+    stats.nb_nogood_hits += branching_stats.nb_nogood_hits;
+    stats.nb_branching_heuristic_choices += branching_stats.nb_branching_heuristic_choices;
+    stats.nb_line_activity_bumps += branching_stats.nb_line_activity_bumps;
 }
 
 std::ostream& operator<<(std::ostream& out, const GridStats& stats)
@@ -105,6 +128,26 @@ std::ostream& operator<<(std::ostream& out, const GridStats& stats)
     {
         out << "Number of single line    full reduction (change/all): " << stats.nb_single_line_full_reduction_w_change << "/" << stats.nb_single_line_full_reduction << std::endl;
     }
+    if (stats.nb_reduction_cache_hits > 0 || stats.nb_reduction_cache_misses > 0)
+    {
+        out << "Reduction cache (hits/misses): " << stats.nb_reduction_cache_hits << "/" << stats.nb_reduction_cache_misses << std::endl;
+    }
+    if (stats.nb_stolen_branching_alternatives > 0)
+    {
+        out << "Branching alternatives stolen by the parallel search: " << stats.nb_stolen_branching_alternatives << std::endl;
+    }
+    if (stats.nb_cell_probing_calls > 0)
+    {
+        out << "Cell probing on " << stats.nb_cell_probing_calls << " tiles, implications (found/tiles set): " << stats.nb_implications << "/" << stats.nb_implied_tiles << std::endl;
+    }
+    if (stats.nb_backjumps > 0 || stats.nb_nogoods > 0)
+    {
+        out << "Backjumps: " << stats.nb_backjumps << " (skipped alternatives: " << stats.nb_backjump_skipped_alternatives << "), nogoods (learned/hits): " << stats.nb_nogoods << "/" << stats.nb_nogood_hits << std::endl;
+    }
+    if (stats.nb_branching_heuristic_choices > 0 || stats.nb_line_activity_bumps > 0)
+    {
+        out << "Branching on a line other than the one with the fewest alternatives: " << stats.nb_branching_heuristic_choices << "/" << stats.nb_branching_calls << ", line activity bumps: " << stats.nb_line_activity_bumps << std::endl;
+    }
 
     return out;
 }
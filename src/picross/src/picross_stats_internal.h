@@ -13,4 +13,7 @@ namespace picross {
 
 void merge_branching_grid_stats(GridStats& stats, const GridStats& branching_stats);
 
+// Same as stats = GridStats(), but the memory of the vectors is kept
+void reset_grid_stats(GridStats& stats);
+
 } // namespace picross
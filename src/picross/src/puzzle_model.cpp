@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "puzzle_model.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace picross {
+
+namespace {
+    std::vector<LineConstraint> build_constraints_from(Line::Type type, const InputGrid& grid)
+    {
+        std::vector<LineConstraint> output;
+        const InputGrid::Constraints& input = get_constraints(grid, type);
+        output.reserve(input.size());
+        std::transform(input.cbegin(), input.cend(), std::back_inserter(output), [type](const auto& c) { return LineConstraint(type, c); });
+        return output;
+    }
+
+    std::vector<LineAutomaton> build_line_automata_from(const std::vector<LineConstraint>& constraints)
+    {
+        std::vector<LineAutomaton> output;
+        output.reserve(constraints.size());
+        std::transform(constraints.cbegin(), constraints.cend(), std::back_inserter(output), [](const auto& c) { return LineAutomaton(c); });
+        return output;
+    }
+
+    unsigned int compute_max_nb_of_segments(const InputGrid& input_grid)
+    {
+        const auto max_k = [](const InputGrid::Constraints& constraints) -> std::size_t {
+            return std::max_element(constraints.cbegin(), constraints.cend(), [](const InputGrid::Constraint& lhs, const InputGrid::Constraint& rhs) {
+                return lhs.size() < rhs.size(); })->size();
+            };
+        return static_cast<unsigned int>(std::max(max_k(input_grid.rows()), max_k(input_grid.cols())));
+    }
+} // namespace
+
+PuzzleModel::PuzzleModel(const InputGrid& grid, bool build_automata)
+    : m_constraints{ build_constraints_from(Line::ROW, grid), build_constraints_from(Line::COL, grid) }
+    , m_automata()
+    , m_max_nb_segments(compute_max_nb_of_segments(grid))
+{
+    if (build_automata)
+    {
+        m_automata[Line::ROW] = build_line_automata_from(m_constraints[Line::ROW]);
+        m_automata[Line::COL] = build_line_automata_from(m_constraints[Line::COL]);
+    }
+    assert(m_constraints[Line::ROW].size() == grid.height());
+    assert(m_constraints[Line::COL].size() == grid.width());
+}
+
+} // namespace picross
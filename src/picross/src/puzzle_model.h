@@ -0,0 +1,46 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Immutable description of a grid, shared by the work grids
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include "line.h"
+#include "line_automaton.h"
+#include "line_constraint.h"
+
+#include <picross/picross.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace picross {
+
+/*
+ * PuzzleModel class
+ *
+ *   The constraints of the rows and the columns of a grid, and the line automata compiled from them. The model is built
+ *   once per solve, then shared by the work grid and all of its nested work grids, at any branching depth, and by the
+ *   workers of the parallel probing and branch search.
+ */
+class PuzzleModel
+{
+public:
+    PuzzleModel(const InputGrid& grid, bool build_automata);
+
+    std::size_t width() const { return m_constraints[Line::COL].size(); }
+    std::size_t height() const { return m_constraints[Line::ROW].size(); }
+    unsigned int max_nb_segments() const { return m_max_nb_segments; }
+    const LineConstraint& constraint(Line::Type type, Line::Index index) const { return m_constraints[type][index]; }
+    bool has_automata() const { return !m_automata[Line::ROW].empty() || !m_automata[Line::COL].empty(); }
+    const LineAutomaton& automaton(Line::Type type, Line::Index index) const { return m_automata[type][index]; }
+
+private:
+    std::vector<LineConstraint>     m_constraints[2];
+    std::vector<LineAutomaton>      m_automata[2];          // Empty if the automata were not requested
+    unsigned int                    m_max_nb_segments;      // Maximum nb of segments on a line constraint
+};
+
+} // namespace picross
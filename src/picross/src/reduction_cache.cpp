@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "reduction_cache.h"
+
+#include "tile_bits.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace picross {
+
+ReductionCache::ReductionCache(std::size_t max_line_length, std::size_t nb_entries)
+    : m_max_line_length(max_line_length)
+    , m_nb_slots(1u)
+    , m_shift(0u)
+    , m_slots()
+    , m_tiles()
+{
+    // Round the number of entries to a power of two
+    unsigned int log2 = 0u;
+    while (m_nb_slots < nb_entries) { m_nb_slots <<= 1; log2++; }
+    m_shift = static_cast<unsigned int>(std::numeric_limits<std::size_t>::digits) - log2;
+    assert(2u * m_nb_slots * max_line_length <= std::numeric_limits<std::uint32_t>::max());
+}
+
+std::size_t ReductionCache::hash(const LineSpan& known_tiles)
+{
+    const std::size_t seed = 2u * static_cast<std::size_t>(known_tiles.index()) + (known_tiles.type() == Line::ROW ? 0u : 1u);
+    return tile_bits::hash(known_tiles.tiles(), known_tiles.size(), seed);
+}
+
+std::size_t ReductionCache::slot_index(std::size_t hash) const
+{
+    // Fibonacci hashing, in order to use the high bits of the product
+    constexpr std::size_t FIBONACCI = 0x9e3779b97f4a7c15ull;
+    return m_shift >= static_cast<unsigned int>(std::numeric_limits<std::size_t>::digits) ? 0u : (hash * FIBONACCI) >> m_shift;
+}
+
+std::optional<ReductionCache::Entry> ReductionCache::read_line(const LineSpan& known_tiles) const
+{
+    if (m_slots.empty())
+        return std::nullopt;
+    const std::size_t h = hash(known_tiles);
+    const Slot& slot = m_slots[slot_index(h)];
+    if (!slot.m_valid || slot.m_hash != h || slot.m_type != known_tiles.type() || slot.m_index != known_tiles.index() || slot.m_size != known_tiles.size())
+        return std::nullopt;
+    const Tile* stored_tiles = m_tiles.data() + slot.m_offset;
+    if (!std::equal(known_tiles.begin(), known_tiles.end(), stored_tiles))
+        return std::nullopt;
+    return Entry{ LineSpan(known_tiles.type(), known_tiles.index(), known_tiles.size(), stored_tiles + known_tiles.size()), slot.m_nb_alt };
+}
+
+void ReductionCache::store_line(const LineSpan& known_tiles, const LineSpan& reduced_line, LineAlternatives::NbAlt nb_alt)
+{
+    assert(known_tiles.size() == reduced_line.size());
+    assert(known_tiles.size() <= m_max_line_length);
+    if (m_slots.empty())
+    {
+        // The memory for the tiles is only reserved here, it is used as the slots get filled
+        m_slots.resize(m_nb_slots);
+        m_tiles.reserve(2u * m_nb_slots * m_max_line_length);
+    }
+    const std::size_t h = hash(known_tiles);
+    Slot& slot = m_slots[slot_index(h)];
+    if (!slot.m_allocated)
+    {
+        assert(m_tiles.size() + 2u * m_max_line_length <= m_tiles.capacity());
+        slot.m_offset = static_cast<std::uint32_t>(m_tiles.size());
+        slot.m_allocated = true;
+        m_tiles.resize(m_tiles.size() + 2u * m_max_line_length);
+    }
+    slot.m_hash = h;
+    slot.m_size = static_cast<std::uint32_t>(known_tiles.size());
+    slot.m_nb_alt = nb_alt;
+    slot.m_type = known_tiles.type();
+    slot.m_index = known_tiles.index();
+    slot.m_valid = true;
+    Tile* stored_tiles = m_tiles.data() + slot.m_offset;
+    std::copy(known_tiles.begin(), known_tiles.end(), stored_tiles);
+    std::copy(reduced_line.begin(), reduced_line.end(), stored_tiles + known_tiles.size());
+}
+
+} // namespace picross
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Cache of the line reductions, shared by the nested work grids
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include "line_alternatives.h"
+#include "line_span.h"
+
+#include <picross/picross.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace picross {
+
+/*
+ * ReductionCache class
+ *
+ *   Bounded cache of the full reductions of the lines of a grid. The key is the line id, which identifies the line constraint,
+ *   and the known tiles of the line. The cache is direct-mapped: a new entry replaces the one stored at the same slot.
+ *   Nothing is allocated until the first line is stored, since many grids are line solved without using the cache.
+ */
+class ReductionCache
+{
+public:
+    ReductionCache(std::size_t max_line_length, std::size_t nb_entries);
+
+    struct Entry
+    {
+        LineSpan                m_reduced_line;
+        LineAlternatives::NbAlt m_nb_alt;
+    };
+
+    // Return an entry if the known tiles are in the cache. Its line span is valid until the next call to store_line().
+    std::optional<Entry> read_line(const LineSpan& known_tiles) const;
+    void store_line(const LineSpan& known_tiles, const LineSpan& reduced_line, LineAlternatives::NbAlt nb_alt);
+
+    std::size_t nb_entries() const { return m_nb_slots; }
+
+private:
+    struct Slot
+    {
+        std::size_t             m_hash = 0u;
+        std::uint32_t           m_offset = 0u;          // Offset of the known tiles, then the reduced tiles, in m_tiles
+        std::uint32_t           m_size = 0u;
+        LineAlternatives::NbAlt m_nb_alt = 0u;
+        Line::Type              m_type = Line::ROW;
+        Line::Index             m_index = 0u;
+        bool                    m_allocated = false;
+        bool                    m_valid = false;
+    };
+    std::size_t slot_index(std::size_t hash) const;
+    static std::size_t hash(const LineSpan& known_tiles);
+
+private:
+    std::size_t         m_max_line_length;
+    std::size_t         m_nb_slots;
+    unsigned int        m_shift;
+    std::vector<Slot>   m_slots;            // Empty until the first line is stored
+    std::vector<Tile>   m_tiles;
+};
+
+} // namespace picross
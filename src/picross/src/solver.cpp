@@ -16,11 +16,41 @@
 #include <memory>
 #include <ostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
 namespace picross {
 
+namespace {
+    SolverPolicy_RampUpMaxNbAlternatives solver_policy_from_config(const SolverConfig& config, bool branching_allowed)
+    {
+        SolverPolicy_RampUpMaxNbAlternatives solver_policy;
+        solver_policy.m_branching_allowed = branching_allowed;
+        solver_policy.m_limit_on_max_nb_alternatives = false;
+        solver_policy.m_probing = config.probing;
+        solver_policy.m_cell_probing = config.probing && config.cell_probing;
+        solver_policy.m_line_cache = config.line_cache;
+        solver_policy.m_backjumping = config.backjumping;
+        solver_policy.m_branching_heuristic = config.branching_heuristic;
+        solver_policy.m_line_solver_engine = config.line_solver_engine;
+        solver_policy.m_nb_threads = config.nb_threads;
+        solver_policy.m_nb_of_lines_for_probing_round = config.nb_lines_per_probing_round;
+        solver_policy.m_nb_of_cells_for_probing_round = config.nb_cells_per_probing_round;
+        solver_policy.m_min_nb_alternatives = config.min_nb_alternatives;
+        solver_policy.m_max_nb_alternatives = config.max_nb_alternatives;
+        solver_policy.m_max_nb_alternatives_probing_edge = config.max_nb_alternatives_probing_edge;
+        solver_policy.m_max_nb_alternatives_probing_other = config.max_nb_alternatives_probing_other;
+        return solver_policy;
+    }
+} // namespace
+
+template <bool BranchingAllowed>
+RefSolver<BranchingAllowed>::RefSolver(const SolverConfig& config)
+    : m_config(config)
+{
+}
+
 template <bool BranchingAllowed>
 Solver::Result RefSolver<BranchingAllowed>::solve(const InputGrid& input_grid, unsigned int max_nb_solutions) const
 {
@@ -33,9 +63,7 @@ Solver::Result RefSolver<BranchingAllowed>::solve(const InputGrid& input_grid, u
         std::swap(*m_stats, new_stats);
     }
 
-    SolverPolicy_RampUpMaxNbAlternatives solver_policy;
-    solver_policy.m_branching_allowed = BranchingAllowed;
-    solver_policy.m_limit_on_max_nb_alternatives = false;
+    const auto solver_policy = solver_policy_from_config(m_config, BranchingAllowed);
 
     WorkGrid<SolverPolicy_RampUpMaxNbAlternatives> work_grid(input_grid, solver_policy, m_observer, m_abort_function);
     work_grid.set_stats(m_stats);
@@ -62,9 +90,7 @@ Solver::Status RefSolver<BranchingAllowed>::solve(const InputGrid& input_grid, S
         std::swap(*m_stats, new_stats);
     }
 
-    SolverPolicy_RampUpMaxNbAlternatives solver_policy;
-    solver_policy.m_branching_allowed = BranchingAllowed;
-    solver_policy.m_limit_on_max_nb_alternatives = false;
+    const auto solver_policy = solver_policy_from_config(m_config, BranchingAllowed);
 
     WorkGrid<SolverPolicy_RampUpMaxNbAlternatives> work_grid(input_grid, solver_policy, m_observer, m_abort_function);
     work_grid.set_stats(m_stats);
@@ -304,12 +330,70 @@ std::string_view str_difficulty_code(DifficultyCode code)
 }
 
 
+std::pair<bool, std::string> check_solver_config(const SolverConfig& config)
+{
+    if (config.min_nb_alternatives == 0u)
+    {
+        return std::make_pair(false, std::string("Invalid min_nb_alternatives = 0"));
+    }
+    if (config.max_nb_alternatives > SolverConfig::MAX_NB_ALTERNATIVES)
+    {
+        std::ostringstream oss;
+        oss << "Invalid max_nb_alternatives = " << config.max_nb_alternatives << " (max: " << SolverConfig::MAX_NB_ALTERNATIVES << ")";
+        return std::make_pair(false, oss.str());
+    }
+    if (config.max_nb_alternatives < config.min_nb_alternatives)
+    {
+        std::ostringstream oss;
+        oss << "max_nb_alternatives = " << config.max_nb_alternatives << " is smaller than min_nb_alternatives = " << config.min_nb_alternatives;
+        return std::make_pair(false, oss.str());
+    }
+    if (config.nb_threads > SolverConfig::MAX_NB_THREADS)
+    {
+        std::ostringstream oss;
+        oss << "Invalid nb_threads = " << config.nb_threads << " (max: " << SolverConfig::MAX_NB_THREADS << ")";
+        return std::make_pair(false, oss.str());
+    }
+    switch (config.line_solver_engine)
+    {
+    case LineSolverEngine::LINE_ALTERNATIVES:
+    case LineSolverEngine::AUTOMATON:
+    case LineSolverEngine::AUTO:
+        break;
+    default:
+        {
+            std::ostringstream oss;
+            oss << "Invalid line_solver_engine = " << static_cast<int>(config.line_solver_engine);
+            return std::make_pair(false, oss.str());
+        }
+    }
+    if (config.probing && config.nb_lines_per_probing_round == 0u)
+    {
+        return std::make_pair(false, std::string("Invalid nb_lines_per_probing_round = 0 with probing enabled"));
+    }
+    if (config.probing && config.cell_probing && config.nb_cells_per_probing_round == 0u)
+    {
+        return std::make_pair(false, std::string("Invalid nb_cells_per_probing_round = 0 with cell probing enabled"));
+    }
+    return std::make_pair(true, std::string());
+}
+
+
 std::unique_ptr<Solver> get_ref_solver()
 {
     return std::make_unique<RefSolver<true>>();
 }
 
 
+std::unique_ptr<Solver> get_ref_solver(const SolverConfig& config)
+{
+    const auto [is_valid, msg] = check_solver_config(config);
+    if (!is_valid)
+        throw std::invalid_argument("Invalid SolverConfig: " + msg);
+    return std::make_unique<RefSolver<true>>(config);
+}
+
+
 std::unique_ptr<Solver> get_line_solver()
 {
     return std::make_unique<RefSolver<false>>();
@@ -18,14 +18,18 @@ template <bool BranchingAllowed = true>
 class RefSolver : public Solver
 {
 public:
+    RefSolver() = default;
+    explicit RefSolver(const SolverConfig& config);
+
     Result solve(const InputGrid& input_grid, unsigned int max_nb_solutions) const override;
     Status solve(const InputGrid& input_grid, SolutionFound solution_found) const override;
     void set_observer(Observer observer) override;
     void set_stats(GridStats& stats) override;
     void set_abort_function(Abort abort) override;
 private:
+    SolverConfig m_config;
     Observer m_observer;
-    GridStats* m_stats;
+    GridStats* m_stats = nullptr;
     Abort m_abort_function;
 };
 
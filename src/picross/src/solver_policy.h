@@ -5,28 +5,50 @@
  ******************************************************************************/
 #pragma once
 
+#include <picross/picross.h>
+
+#include "binomial.h"
+
 namespace picross {
 
 struct SolverPolicyBase
 {
-    static constexpr bool LINE_CACHE_ENABLED = true;
-    static constexpr unsigned int MIN_NB_ALTERNATIVES = 1 << 10;
+    using NbAlt = binomial::Rep;
+
+    static constexpr bool REDUCTION_CACHE_ENABLED = true;
+    static constexpr unsigned int REDUCTION_CACHE_NB_ENTRIES_PER_LINE = 16;
+    static constexpr unsigned int IMPLICATIONS_MAX_NB_ENTRIES = 1 << 20;
+    static constexpr unsigned int NOGOODS_MAX_NB_LINES = 1 << 16;
     static constexpr unsigned int PARTIAL_REDUCE_NB_CONSTRAINTS = 1;
+    static constexpr unsigned int BRANCHING_ACTIVITY_NB_CANDIDATE_LINES = 8;   // With the fewest alternatives, see BranchingHeuristic::ACTIVITY
 
     bool m_branching_allowed = false;
+    bool m_probing = true;                                      // Probing rounds on the root grid, before the branch search
+    bool m_line_cache = true;                                   // Cache of the reductions of the lines orthogonal to a probed or branching line
     bool m_limit_on_max_nb_alternatives = false;
+    bool m_nested_grid_trail = true;
+    bool m_parallel_branching = true;                           // Parallel branch search, if m_nb_threads is not one
+    bool m_parallel_probing = true;                             // Parallel probing rounds, if m_nb_threads is not one
+    bool m_cell_probing = true;                                 // Probe the tiles of the lines that were not probed
+    bool m_backjumping = true;                                  // Conflict-directed backjumping and nogood learning in the branch search
+    LineSolverEngine m_line_solver_engine = LineSolverEngine::AUTO;
+    BranchingHeuristic m_branching_heuristic = BranchingHeuristic::FEWEST_ALTERNATIVES;
     unsigned int m_nb_of_lines_for_probing_round = 12;
-    unsigned int m_max_nb_alternatives_probing_edge  = 1 << 12;
-    unsigned int m_max_nb_alternatives_probing_other = 1 << 8;
-    unsigned int m_max_nb_alternatives = 1 << 26;
+    unsigned int m_nb_of_cells_for_probing_round = 16;
+    unsigned int m_nb_threads = 1;                              // Threads of the parallel grid passes, branch search and probing. Zero: one per hardware thread
+    unsigned int m_min_nb_lines_parallel_pass = 64;             // Below that number of lines to reduce, a grid pass is sequential
+    NbAlt m_max_nb_alternatives_probing_edge  = 1 << 12;
+    NbAlt m_max_nb_alternatives_probing_other = 1 << 8;
+    NbAlt m_min_nb_alternatives = 1 << 10;                      // Max number of alternatives of the lines fully reduced by the first full grid pass
+    NbAlt m_max_nb_alternatives = 1 << 26;
 };
 
 struct SolverPolicy_RampUpMaxNbAlternatives : public SolverPolicyBase
 {
-    unsigned int get_max_nb_alternatives(unsigned int previous_max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
-    bool continue_line_solving(unsigned int max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
-    bool switch_to_branching(unsigned int max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
-    bool switch_to_probing(unsigned int branching_depth, unsigned int max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
+    NbAlt get_max_nb_alternatives(NbAlt previous_max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
+    bool continue_line_solving(NbAlt max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
+    bool switch_to_branching(NbAlt max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
+    bool switch_to_probing(unsigned int branching_depth, NbAlt max_nb_alternatives, bool grid_changed, unsigned int skipped_lines) const;
 };
 
 } // namespace picross
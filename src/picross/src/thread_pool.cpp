@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace picross {
+
+ThreadPool::ThreadPool(unsigned int nb_threads)
+    : m_workers()
+    , m_mutex()
+    , m_start_condition()
+    , m_done_condition()
+    , m_generation(0u)
+    , m_running(false)
+    , m_nb_running_workers(0u)
+    , m_stop(false)
+    , m_task(nullptr)
+    , m_context(nullptr)
+    , m_nb_iterations(0u)
+    , m_next_iteration(0u)
+    , m_exception()
+{
+    if (nb_threads == 0u)
+        nb_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    m_workers.reserve(nb_threads - 1u);
+    for (unsigned int thread_idx = 1u; thread_idx < nb_threads; thread_idx++)
+        m_workers.emplace_back(&ThreadPool::worker_loop, this, thread_idx);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start_condition.notify_all();
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::run(std::size_t nb_iterations, Task task, void* context)
+{
+    assert(!m_running);
+    if (m_workers.empty() || nb_iterations <= 1u)
+    {
+        m_running = true;
+        try
+        {
+            for (std::size_t idx = 0u; idx < nb_iterations; idx++)
+                task(context, idx, 0u);
+        }
+        catch (...)
+        {
+            m_running = false;
+            throw;
+        }
+        m_running = false;
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        assert(m_nb_running_workers == 0u);
+        m_running = true;
+        m_task = task;
+        m_context = context;
+        m_nb_iterations = nb_iterations;
+        m_next_iteration.store(0u, std::memory_order_relaxed);
+        m_exception = nullptr;
+        m_nb_running_workers = static_cast<unsigned int>(m_workers.size());
+        m_generation++;
+    }
+    m_start_condition.notify_all();
+    run_iterations(0u);
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_condition.wait(lock, [this]() { return m_nb_running_workers == 0u; });
+        std::swap(exception, m_exception);
+        m_running = false;
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void ThreadPool::worker_loop(unsigned int thread_idx)
+{
+    std::uint64_t generation = 0u;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_condition.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+            if (m_stop)
+                return;
+            generation = m_generation;
+        }
+        run_iterations(thread_idx);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            assert(m_nb_running_workers > 0u);
+            if (--m_nb_running_workers == 0u)
+                m_done_condition.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run_iterations(unsigned int thread_idx)
+{
+    while (true)
+    {
+        const std::size_t idx = m_next_iteration.fetch_add(1u, std::memory_order_relaxed);
+        if (idx >= m_nb_iterations)
+            return;
+        try
+        {
+            m_task(m_context, idx, thread_idx);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_exception)
+                m_exception = std::current_exception();
+        }
+    }
+}
+
+} // namespace picross
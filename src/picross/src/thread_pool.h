@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Pool of threads for the parallel loops of the solver
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace picross {
+
+/*
+ * ThreadPool class
+ *
+ *   A fixed set of threads running the iterations of a parallel loop. The thread calling parallel_for() takes part in the
+ *   loop, therefore a pool of N threads starts N - 1 worker threads. A loop does not allocate memory.
+ *
+ *   parallel_for() must not be called concurrently on the same pool, including from the iterations of a loop.
+ */
+class ThreadPool
+{
+public:
+    // A number of threads equal to zero means one thread per hardware thread
+    explicit ThreadPool(unsigned int nb_threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int nb_threads() const { return static_cast<unsigned int>(m_workers.size()) + 1u; }
+
+    // True during a call to parallel_for(). Can be called from the iterations of the loop.
+    bool is_running() const { return m_running; }
+
+    // Call f(idx, thread_idx) for each idx in [0, nb_iterations), with thread_idx in [0, nb_threads()) the index of the
+    // calling thread. Return once all the calls are done. If a call throws, the first exception is rethrown.
+    template <typename F>
+    void parallel_for(std::size_t nb_iterations, F& f)
+    {
+        run(nb_iterations, [](void* context, std::size_t idx, unsigned int thread_idx) { (*static_cast<F*>(context))(idx, thread_idx); }, &f);
+    }
+
+private:
+    using Task = void (*)(void* context, std::size_t idx, unsigned int thread_idx);
+    void run(std::size_t nb_iterations, Task task, void* context);
+    void worker_loop(unsigned int thread_idx);
+    void run_iterations(unsigned int thread_idx);
+
+private:
+    std::vector<std::thread>    m_workers;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_start_condition;
+    std::condition_variable     m_done_condition;
+    std::uint64_t               m_generation;           // Incremented at the start of each loop
+    bool                        m_running;              // Only modified by the thread calling parallel_for()
+    unsigned int                m_nb_running_workers;
+    bool                        m_stop;
+    Task                        m_task;
+    void*                       m_context;
+    std::size_t                 m_nb_iterations;
+    std::atomic<std::size_t>    m_next_iteration;
+    std::exception_ptr          m_exception;
+};
+
+} // namespace picross
@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#include "tile_bits.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+
+namespace picross {
+
+namespace {
+    using Word = std::uint64_t;
+
+    constexpr std::size_t TILES_PER_WORD = sizeof(Word);
+    constexpr Word LOW_BITS = 0x0101010101010101ull;        // Bit 0 of each byte
+
+    static_assert(sizeof(Tile) == 1u);
+    static_assert(static_cast<unsigned char>(Tile::UNKNOWN) == 0u);
+    static_assert(static_cast<unsigned char>(Tile::EMPTY) == 1u);
+    static_assert(static_cast<unsigned char>(Tile::FILLED) == 2u);
+
+    inline Word load(const Tile* tiles)
+    {
+        Word w;
+        std::memcpy(&w, tiles, sizeof(Word));
+        return w;
+    }
+
+    inline void store(Tile* tiles, Word w)
+    {
+        std::memcpy(tiles, &w, sizeof(Word));
+    }
+
+    inline unsigned int popcount(Word w)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_popcountll(w));
+#else
+        unsigned int count = 0u;
+        for (; w != 0u; w &= w - 1u) { count++; }
+        return count;
+#endif
+    }
+
+    // Bit 0 of each byte is set if the tile is incompatible (one is empty, the other is filled)
+    inline Word incompatible_tiles(Word lhs, Word rhs)
+    {
+        const Word x = lhs | rhs;
+        return x & (x >> 1) & LOW_BITS;
+    }
+
+    // Bit 0 of each byte is set if the tile is known
+    inline Word known_tiles(Word w)
+    {
+        return (w | (w >> 1)) & LOW_BITS;
+    }
+
+    template <typename WordOp, typename TileOp>
+    inline void transform(Tile* lhs, const Tile* rhs, std::size_t size, WordOp word_op, TileOp tile_op)
+    {
+        std::size_t idx = 0u;
+        for (; idx + TILES_PER_WORD <= size; idx += TILES_PER_WORD)
+            store(lhs + idx, word_op(load(lhs + idx), load(rhs + idx)));
+        for (; idx < size; idx++)
+            lhs[idx] = tile_op(lhs[idx], rhs[idx]);
+    }
+
+    inline Tile tile_from_bits(unsigned int bits)
+    {
+        return static_cast<Tile>(bits);
+    }
+
+    inline unsigned int bits_from_tile(Tile t)
+    {
+        return static_cast<unsigned int>(t);
+    }
+} // namespace
+
+namespace tile_bits {
+
+bool are_compatible(const Tile* lhs, const Tile* rhs, std::size_t size)
+{
+    std::size_t idx = 0u;
+    Word acc = 0u;
+    for (; idx + TILES_PER_WORD <= size; idx += TILES_PER_WORD)
+        acc |= incompatible_tiles(load(lhs + idx), load(rhs + idx));
+    for (; idx < size; idx++)
+        acc |= static_cast<Word>((bits_from_tile(lhs[idx]) | bits_from_tile(rhs[idx])) == 3u);
+    return acc == 0u;
+}
+
+bool is_completed(const Tile* tiles, std::size_t size)
+{
+    std::size_t idx = 0u;
+    for (; idx + TILES_PER_WORD <= size; idx += TILES_PER_WORD)
+        if (known_tiles(load(tiles + idx)) != LOW_BITS)
+            return false;
+    return std::none_of(tiles + idx, tiles + size, [](const Tile t) { return t == Tile::UNKNOWN; });
+}
+
+std::size_t nb_unknown(const Tile* tiles, std::size_t size)
+{
+    std::size_t idx = 0u;
+    std::size_t count = 0u;
+    for (; idx + TILES_PER_WORD <= size; idx += TILES_PER_WORD)
+        count += TILES_PER_WORD - popcount(known_tiles(load(tiles + idx)));
+    return count + static_cast<std::size_t>(std::count(tiles + idx, tiles + size, Tile::UNKNOWN));
+}
+
+void add(Tile* lhs, const Tile* rhs, std::size_t size)
+{
+    assert(are_compatible(lhs, rhs, size));
+    transform(lhs, rhs, size,
+        [](Word l, Word r) { return l | r; },
+        [](Tile l, Tile r) { return tile_from_bits(bits_from_tile(l) | bits_from_tile(r)); });
+}
+
+void delta(Tile* lhs, const Tile* rhs, std::size_t size)
+{
+    assert(are_compatible(lhs, rhs, size));
+    transform(lhs, rhs, size,
+        [](Word l, Word r) { return l & ~r; },
+        [](Tile l, Tile r) { return tile_from_bits(bits_from_tile(l) & ~bits_from_tile(r)); });
+}
+
+void reduce(Tile* lhs, const Tile* rhs, std::size_t size)
+{
+    transform(lhs, rhs, size,
+        [](Word l, Word r) { return l & r; },
+        [](Tile l, Tile r) { return tile_from_bits(bits_from_tile(l) & bits_from_tile(r)); });
+}
+
+std::size_t hash(const Tile* tiles, std::size_t size, std::size_t seed)
+{
+    std::size_t result = seed ^ std::hash<std::size_t>{}(size);
+    const auto combine = [&result](Word w) {
+        // Same combination as boost::hash_combine
+        result ^= std::hash<Word>{}(w) + 0x9e3779b9u + (result << 6) + (result >> 2);
+    };
+    std::size_t idx = 0u;
+    for (; idx + TILES_PER_WORD <= size; idx += TILES_PER_WORD)
+        combine(load(tiles + idx));
+    if (idx < size)
+    {
+        Word w = 0u;
+        std::memcpy(&w, tiles + idx, size - idx);
+        combine(w);
+    }
+    return result;
+}
+
+} // namespace tile_bits
+
+
+BitPlanes::BitPlanes(std::size_t size)
+    : m_size(size)
+    , m_filled((size + WORD_BITS - 1u) / WORD_BITS, Word{0})
+    , m_empty((size + WORD_BITS - 1u) / WORD_BITS, Word{0})
+{}
+
+BitPlanes::BitPlanes(const Tile* tiles, std::size_t size)
+    : BitPlanes(size)
+{
+    assign(tiles, size);
+}
+
+Tile BitPlanes::get(std::size_t idx) const
+{
+    assert(idx < m_size);
+    const auto word_idx = idx / WORD_BITS;
+    const auto bit_idx = idx % WORD_BITS;
+    const auto bits = static_cast<unsigned int>(((m_empty[word_idx] >> bit_idx) & 1u) | (((m_filled[word_idx] >> bit_idx) & 1u) << 1));
+    return tile_from_bits(bits);
+}
+
+void BitPlanes::assign(const Tile* tiles, std::size_t size)
+{
+    if (size != m_size)
+    {
+        m_size = size;
+        m_filled.resize((size + WORD_BITS - 1u) / WORD_BITS);
+        m_empty.resize(m_filled.size());
+    }
+    for (std::size_t word_idx = 0u; word_idx < m_filled.size(); word_idx++)
+    {
+        const auto begin = word_idx * WORD_BITS;
+        const auto end = std::min(begin + WORD_BITS, m_size);
+        Word filled = 0u;
+        Word empty = 0u;
+        for (auto idx = begin; idx < end; idx++)
+        {
+            const auto bits = static_cast<Word>(bits_from_tile(tiles[idx]));
+            empty |= (bits & 1u) << (idx - begin);
+            filled |= (bits >> 1) << (idx - begin);
+        }
+        m_filled[word_idx] = filled;
+        m_empty[word_idx] = empty;
+    }
+}
+
+void BitPlanes::reduce(const Tile* tiles, std::size_t size)
+{
+    assert(size == m_size);
+    for (std::size_t word_idx = 0u; word_idx < m_filled.size(); word_idx++)
+    {
+        // Skip the words where nothing is known anymore
+        if ((m_filled[word_idx] | m_empty[word_idx]) == 0u)
+            continue;
+        const auto begin = word_idx * WORD_BITS;
+        const auto end = std::min(begin + WORD_BITS, size);
+        Word filled = 0u;
+        Word empty = 0u;
+        for (auto idx = begin; idx < end; idx++)
+        {
+            const auto bits = static_cast<Word>(bits_from_tile(tiles[idx]));
+            empty |= (bits & 1u) << (idx - begin);
+            filled |= (bits >> 1) << (idx - begin);
+        }
+        m_filled[word_idx] &= filled;
+        m_empty[word_idx] &= empty;
+    }
+}
+
+void BitPlanes::reduce(const BitPlanes& other)
+{
+    assert(other.m_size == m_size);
+    for (std::size_t word_idx = 0u; word_idx < m_filled.size(); word_idx++)
+    {
+        m_filled[word_idx] &= other.m_filled[word_idx];
+        m_empty[word_idx] &= other.m_empty[word_idx];
+    }
+}
+
+void BitPlanes::copy_to(Tile* out, std::size_t begin, std::size_t size) const
+{
+    assert(begin + size <= m_size);
+    for (std::size_t idx = 0u; idx < size; idx++)
+        out[idx] = get(begin + idx);
+}
+
+bool BitPlanes::is_completed() const
+{
+    return nb_filled() + nb_empty() == m_size;
+}
+
+std::size_t BitPlanes::nb_filled() const
+{
+    std::size_t count = 0u;
+    for (const Word w : m_filled)
+        count += popcount(w);
+    return count;
+}
+
+std::size_t BitPlanes::nb_empty() const
+{
+    std::size_t count = 0u;
+    for (const Word w : m_empty)
+        count += popcount(w);
+    return count;
+}
+
+bool operator==(const BitPlanes& lhs, const BitPlanes& rhs)
+{
+    return lhs.m_size == rhs.m_size
+        && lhs.m_filled == rhs.m_filled
+        && lhs.m_empty == rhs.m_empty;
+}
+
+bool operator!=(const BitPlanes& lhs, const BitPlanes& rhs)
+{
+    return !(lhs == rhs);
+}
+
+} // namespace picross
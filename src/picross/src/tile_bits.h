@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * PICROSS SOLVER
+ *
+ *   Declaration of the PRIVATE API of the Picross solver
+ *
+ * Copyright (c) 2010-2023 Pierre DEJOUE
+ ******************************************************************************/
+#pragma once
+
+#include <picross/picross.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace picross {
+
+/*
+ * Word-parallel operations on arrays of tiles
+ *
+ *   The Tile encoding is a pair of bit-planes: bit 0 is set if the tile is known to be empty,
+ *   bit 1 is set if the tile is known to be filled. Both bits are never set at the same time.
+ *   Those functions process the tiles eight at a time (SWAR), using 64-bit AND/OR operations.
+ */
+namespace tile_bits {
+
+bool are_compatible(const Tile* lhs, const Tile* rhs, std::size_t size);
+
+// Return true if none of the tiles is unknown
+bool is_completed(const Tile* tiles, std::size_t size);
+
+std::size_t nb_unknown(const Tile* tiles, std::size_t size);
+
+// lhs = lhs + rhs (the two arrays must be compatible)
+void add(Tile* lhs, const Tile* rhs, std::size_t size);
+
+// lhs = lhs - rhs, where lhs = rhs + delta (the two arrays must be compatible)
+void delta(Tile* lhs, const Tile* rhs, std::size_t size);
+
+// Keep the information that is common to lhs and rhs
+void reduce(Tile* lhs, const Tile* rhs, std::size_t size);
+
+std::size_t hash(const Tile* tiles, std::size_t size, std::size_t seed = 0u);
+
+} // namespace tile_bits
+
+/*
+ * BitPlanes class
+ *
+ *   Compact storage of an array of tiles as two bit-planes, "known filled" and "known empty".
+ *   This is four times smaller than the byte-per-tile storage of the Grid.
+ */
+class BitPlanes
+{
+public:
+    using Word = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64u;
+public:
+    explicit BitPlanes(std::size_t size = 0u);
+    BitPlanes(const Tile* tiles, std::size_t size);
+
+    std::size_t size() const { return m_size; }
+
+    Tile get(std::size_t idx) const;
+
+    void assign(const Tile* tiles, std::size_t size);
+
+    // Keep the information that is common to *this and tiles
+    void reduce(const Tile* tiles, std::size_t size);
+    void reduce(const BitPlanes& other);
+
+    // Write the tiles [begin, begin + size) to the output array
+    void copy_to(Tile* out, std::size_t begin, std::size_t size) const;
+
+    bool is_completed() const;
+    std::size_t nb_filled() const;
+    std::size_t nb_empty() const;
+
+    friend bool operator==(const BitPlanes& lhs, const BitPlanes& rhs);
+
+private:
+    std::size_t         m_size;
+    std::vector<Word>   m_filled;
+    std::vector<Word>   m_empty;
+};
+
+bool operator!=(const BitPlanes& lhs, const BitPlanes& rhs);
+
+} // namespace picross
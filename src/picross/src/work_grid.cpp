@@ -21,6 +21,7 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <type_traits>
 
@@ -34,32 +35,30 @@ namespace {
 constexpr bool PARTIAL_SOLUTION = true;
 constexpr bool FULL_SOLUTION = false;
 
-std::vector<LineConstraint> build_constraints_from(Line::Type type, const InputGrid& grid)
-{
-    std::vector<LineConstraint> output;
-    const InputGrid::Constraints& input = get_constraints(grid, type);
-    output.reserve(input.size());
-    std::transform(input.cbegin(), input.cend(), std::back_inserter(output), [type](const auto& c) { return LineConstraint(type, c); });
-    return output;
-}
+// A nested grid stops recording its trail once it has set more than that fraction of the tiles of the grid
+constexpr std::size_t TRAIL_MAX_RATIO = 8u;
 
-std::vector<LineAlternatives> build_line_alternatives_from(Line::Type type, const std::vector<LineConstraint>& constraints, const Grid& grid, binomial::Cache& binomial)
+inline std::size_t lowest_bit(std::uint64_t word)
 {
-    std::vector<LineAlternatives> output;
-    output.reserve(constraints.size());
-    Line::Index idx = 0;
-    std::transform(constraints.cbegin(), constraints.cend(), std::back_inserter(output), [type, &grid, &idx, &binomial](const auto& c) { return LineAlternatives(c, grid.get_line(type, idx++), binomial); });
-    return output;
+    assert(word != 0u);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    std::size_t bit = 0u;
+    while (((word >> bit) & 1u) == 0u) { bit++; }
+    return bit;
+#endif
 }
 
-template <bool B>
-void update_line_range(LineRange& range, const std::vector<bool>& source)
+template <bool B, typename Source>
+void update_line_range(LineRange& range, std::size_t size, Source source)
 {
     assert(range.m_begin <= range.m_end);
-    assert(0 <= range.m_begin && (range.empty() || (range.m_begin < source.size())));
-    assert(0 <= range.m_end && range.m_end <= source.size());
-    while (range.m_begin < range.m_end && source[range.m_begin] == B)    { range.m_begin++; }
-    while (range.m_begin < range.m_end && source[range.m_end - 1u] == B) { range.m_end--; }
+    assert(0 <= range.m_begin && (range.empty() || (range.m_begin < size)));
+    assert(0 <= range.m_end && range.m_end <= size);
+    UNUSED(size);
+    while (range.m_begin < range.m_end && source(range.m_begin) == B)    { range.m_begin++; }
+    while (range.m_begin < range.m_end && source(range.m_end - 1u) == B) { range.m_end--; }
     assert(range.m_begin <= range.m_end);
 }
 
@@ -82,13 +81,23 @@ std::pair<float, float> nested_progress_bar(const std::pair<float, float>& progr
     return std::make_pair(progress_bar.first + (progress_bar.second - progress_bar.first) * ratio_min_f, progress_bar.first + (progress_bar.second - progress_bar.first) * ratio_max_f);
 }
 
-unsigned int compute_max_nb_of_segments(const InputGrid& input_grid)
+// The bit of a branching depth in the bitset of the decision levels
+inline std::uint64_t decision_level_bit(unsigned int depth)
 {
-    const auto max_k = [](const InputGrid::Constraints& constraints) -> std::size_t {
-        return std::max_element(constraints.cbegin(), constraints.cend(), [](const InputGrid::Constraint& lhs, const InputGrid::Constraint& rhs) {
-            return lhs.size() < rhs.size(); })->size();
-        };
-    return static_cast<unsigned int>(std::max(max_k(input_grid.rows()), max_k(input_grid.cols())));
+    return std::uint64_t{1} << std::min(depth, 63u);
+}
+
+// The bits of all the branching depths up to depth
+inline std::uint64_t decision_levels_up_to(unsigned int depth)
+{
+    return depth >= 63u ? ~std::uint64_t{0} : decision_level_bit(depth + 1u) - 1u;
+}
+
+// The observer reports the number of alternatives on 32 bits
+std::uint32_t observer_nb_alternatives(LineAlternatives::NbAlt nb_alternatives)
+{
+    constexpr auto MAX = std::numeric_limits<std::uint32_t>::max();
+    return nb_alternatives >= MAX ? MAX : static_cast<std::uint32_t>(nb_alternatives);
 }
 
 }  // namespace
@@ -132,37 +141,65 @@ std::ostream& operator<<(std::ostream& out, WorkGridState state)
 
 template <typename SolverPolicy>
 WorkGrid<SolverPolicy>::WorkGrid(const InputGrid& grid, const SolverPolicy& solver_policy, Observer observer, Solver::Abort abort_function, float min_progress, float max_progress)
-    : Grid(grid.width(), grid.height(), Tile::UNKNOWN, grid.name())
+    : WorkGrid(std::make_shared<PuzzleModel>(grid, solver_policy.m_line_solver_engine != LineSolverEngine::LINE_ALTERNATIVES), grid.name(), solver_policy, std::move(observer), std::move(abort_function), min_progress, max_progress)
+{}
+
+// Also used to allocate the root grid of a worker of the parallel branch search, which shares the puzzle model of the
+// main grid but none of its buffers
+template <typename SolverPolicy>
+WorkGrid<SolverPolicy>::WorkGrid(std::shared_ptr<const PuzzleModel> model, std::string_view name, const SolverPolicy& solver_policy, Observer observer, Solver::Abort abort_function, float min_progress, float max_progress)
+    : Grid(model->width(), model->height(), Tile::UNKNOWN, name)
     , m_state(WorkGridState::INITIAL_PASS)
     , m_solver_policy(solver_policy)
-    , m_max_k(compute_max_nb_of_segments(grid))
-    , m_constraints()
+    , m_model(std::move(model))
     , m_alternatives()
-    , m_line_completed()
-    , m_line_has_updates()
-    , m_line_is_fully_reduced()
-    , m_line_probed()
-    , m_nb_alternatives()
+    , m_line_states()
     , m_uncompleted_lines_range()
     , m_all_lines()
     , m_uncompleted_lines_end(m_all_lines.end())
+    , m_lines_to_reduce()
+    , m_pass_worklist()
+    , m_lines_buffer()
+    , m_probing_candidates()
+    , m_probed_cells()
+    , m_implication_buffer()
+    , m_probing_snapshot(0u, 0u)
+    , m_probing_row()
+    , m_pass_in_progress(false)
+    , m_pass_rank(0u)
     , m_grid_stats(nullptr)
     , m_observer(std::move(observer))
     , m_abort_function(std::move(abort_function))
-    , m_max_nb_alternatives(SolverPolicy::MIN_NB_ALTERNATIVES)
+    , m_max_nb_alternatives(m_solver_policy.m_min_nb_alternatives)
     , m_branching_depth(0u)
     , m_probing_depth_incr(0u)
     , m_progress_bar(min_progress, max_progress)
     , m_nested_work_grid()
+    , m_nested_grid_stats()
+    , m_trail()
     , m_branch_line_cache()
     , m_full_reduction_buffers()
+    , m_automaton_buffers()
+    , m_reduction_cache()
+    , m_implications(std::make_shared<ImplicationGraph>(width(), height(), SolverPolicy::IMPLICATIONS_MAX_NB_ENTRIES))
+    , m_nogoods(std::make_shared<NogoodStore>(SolverPolicy::NOGOODS_MAX_NB_LINES))
+    , m_nogood_buffer()
+    , m_conflict_levels(0u)
+    , m_line_activity(solver_policy.m_branching_heuristic == BranchingHeuristic::ACTIVITY ? std::make_shared<LineActivity>(width(), height()) : nullptr)
     , m_binomial(std::make_shared<binomial::Cache>())
+    , m_arena(std::make_shared<Arena>())
+    , m_line_buffers(std::make_shared<std::vector<LineBuffers>>())
+    , m_thread_pool()
+    , m_parallel_pass()
+    , m_parallel_search(nullptr)
+    , m_worker_grids()
 {
     assert(m_binomial);
+    assert(m_arena);
 
-    if constexpr (SolverPolicy::LINE_CACHE_ENABLED)
+    if (m_solver_policy.m_line_cache)
     {
-        m_branch_line_cache = LineCache(grid.width(), grid.height());
+        m_branch_line_cache = LineCache(width(), height());
     }
 
     m_all_lines.reserve(width() + height());
@@ -176,28 +213,57 @@ WorkGrid<SolverPolicy>::WorkGrid(const InputGrid& grid, const SolverPolicy& solv
     }
     m_uncompleted_lines_end = m_all_lines.end();
 
-    m_constraints[Line::ROW] = build_constraints_from(Line::ROW, grid);
-    m_constraints[Line::COL] = build_constraints_from(Line::COL, grid);
-    m_alternatives[Line::ROW] = build_line_alternatives_from(Line::ROW, m_constraints[Line::ROW], static_cast<const Grid&>(*this), *m_binomial);
-    m_alternatives[Line::COL] = build_line_alternatives_from(Line::COL, m_constraints[Line::COL], static_cast<const Grid&>(*this), *m_binomial);
-    m_line_completed[Line::ROW].resize(height(), false);
-    m_line_completed[Line::COL].resize(width(), false);
-    m_line_has_updates[Line::ROW].resize(height(), false);
-    m_line_has_updates[Line::COL].resize(width(), false);
-    m_line_is_fully_reduced[Line::ROW].resize(height(), false);
-    m_line_is_fully_reduced[Line::COL].resize(width(), false);
-    m_line_probed[Line::ROW].resize(height(), false);
-    m_line_probed[Line::COL].resize(width(), false);
-    m_nb_alternatives[Line::ROW].resize(height(), 0u);
-    m_nb_alternatives[Line::COL].resize(width(), 0u);
+    assert(m_model);
+    m_alternatives[Line::ROW].resize(height());
+    m_alternatives[Line::COL].resize(width());
+    if (m_model->has_automata())
+    {
+        m_automaton_buffers = std::make_shared<LineAutomaton::Buffers>();
+    }
+    m_line_states.resize(height() + width());
+    for (LineState& state : m_line_states)
+        state.m_to_reduce = true;
+    m_line_buffers->reserve(m_all_lines.size());
+    for (const LineId& line_id : m_all_lines)
+    {
+        const LineSpan line = get_line(line_id);
+        m_line_buffers->push_back(LineBuffers{ reduction_of_line(line), line_from_line_span(line), std::nullopt, std::nullopt });
+    }
+    m_lines_to_reduce = m_all_lines;
+    m_pass_worklist.resize((m_all_lines.size() + WORKLIST_WORD_BITS - 1u) / WORKLIST_WORD_BITS, 0u);
+    update_line_ranks();
     m_uncompleted_lines_range[Line::ROW] = { 0u, static_cast<Line::Index>(height()) };
     m_uncompleted_lines_range[Line::COL] = { 0u, static_cast<Line::Index>(width()) };
 
     const auto max_line_length = static_cast<unsigned int>( std::max(width(), height()));
-    m_full_reduction_buffers = std::make_shared<FullReductionBuffers>(m_max_k, max_line_length);
+    m_full_reduction_buffers = std::make_shared<FullReductionBuffers>(m_model->max_nb_segments(), max_line_length);
+    if constexpr (SolverPolicy::REDUCTION_CACHE_ENABLED)
+    {
+        m_reduction_cache = std::make_shared<ReductionCache>(max_line_length, SolverPolicy::REDUCTION_CACHE_NB_ENTRIES_PER_LINE * m_all_lines.size());
+    }
+
+    // The threads of the parallel grid passes are only started on the large grids. Otherwise they are started if the
+    // solver probes or branches, see start_thread_pool().
+    if (solver_policy.m_nb_threads != 1u && m_all_lines.size() >= solver_policy.m_min_nb_lines_parallel_pass)
+    {
+        m_thread_pool = std::make_shared<ThreadPool>(solver_policy.m_nb_threads);
+        const unsigned int nb_threads = m_thread_pool->nb_threads();
+        if (nb_threads > 1u)
+        {
+            m_parallel_pass = std::make_shared<ParallelPass>();
+            for (unsigned int thread_idx = 0u; thread_idx < nb_threads; thread_idx++)
+                m_parallel_pass->m_thread_buffers.push_back(std::make_unique<ThreadBuffers>(m_model->max_nb_segments(), max_line_length));
+            // The binomial numbers of the linear reductions are then only read by the threads
+            m_binomial->reserve(max_line_length, m_model->max_nb_segments() + 1u);
+        }
+        else
+        {
+            m_thread_pool.reset();
+        }
+    }
 
-    assert(m_constraints[Line::ROW].size() == height());
-    assert(m_constraints[Line::COL].size() == width());
+    assert(m_model->height() == height());
+    assert(m_model->width() == width());
 }
 
 // Allocator for the nested work grid
@@ -206,65 +272,181 @@ WorkGrid<SolverPolicy>::WorkGrid(const WorkGrid& parent)
     : Grid(parent.width(), parent.height(), Tile::UNKNOWN, parent.name())
     , m_state(WorkGridState::INITIAL_PASS)
     , m_solver_policy(parent.m_solver_policy)
-    , m_max_k(parent.m_max_k)
-    , m_constraints()
+    , m_model(parent.m_model)
     , m_alternatives()
-    , m_line_completed()
-    , m_line_has_updates()
-    , m_line_is_fully_reduced()
-    , m_line_probed()
-    , m_nb_alternatives()
+    , m_line_states()
     , m_uncompleted_lines_range()
     , m_all_lines()
     , m_uncompleted_lines_end(m_all_lines.end())
+    , m_lines_to_reduce()
+    , m_pass_worklist()
+    , m_lines_buffer()
+    , m_probing_candidates()
+    , m_probed_cells()
+    , m_implication_buffer()
+    , m_probing_snapshot(0u, 0u)
+    , m_probing_row()
+    , m_pass_in_progress(false)
+    , m_pass_rank(0u)
     , m_grid_stats(nullptr)
     , m_observer(parent.m_observer)
     , m_abort_function(parent.m_abort_function)
-    , m_max_nb_alternatives(SolverPolicy::MIN_NB_ALTERNATIVES)
+    , m_max_nb_alternatives(m_solver_policy.m_min_nb_alternatives)
     , m_branching_depth(parent.m_branching_depth + 1u)
     , m_probing_depth_incr(0u)
     , m_progress_bar(parent.m_progress_bar)
     , m_nested_work_grid()
+    , m_nested_grid_stats()
+    , m_trail()
     , m_branch_line_cache()
     , m_full_reduction_buffers(parent.m_full_reduction_buffers)
+    , m_automaton_buffers(parent.m_automaton_buffers)
+    , m_reduction_cache(parent.m_reduction_cache)
+    , m_implications(parent.m_implications)
+    , m_nogoods(parent.m_nogoods)
+    , m_nogood_buffer()
+    , m_conflict_levels(0u)
+    , m_line_activity(parent.m_line_activity)
     , m_binomial(parent.m_binomial)
+    , m_arena(parent.m_arena)
+    , m_line_buffers(parent.m_line_buffers)
+    , m_thread_pool(parent.m_thread_pool)
+    , m_parallel_pass(parent.m_parallel_pass)
+    , m_parallel_search(parent.m_parallel_search)
+    , m_worker_grids()
 {
     assert(m_binomial);
+    assert(m_arena);
 
-    if constexpr (SolverPolicy::LINE_CACHE_ENABLED)
+    if (m_solver_policy.m_line_cache)
     {
         m_branch_line_cache = LineCache(parent.width(), parent.height());
     }
 
-    m_constraints[Line::ROW] = parent.m_constraints[Line::ROW];
-    m_constraints[Line::COL] = parent.m_constraints[Line::COL];
-    m_alternatives[Line::ROW] = build_line_alternatives_from(Line::ROW, m_constraints[Line::ROW], static_cast<const Grid&>(*this), *m_binomial);
-    m_alternatives[Line::COL] = build_line_alternatives_from(Line::COL, m_constraints[Line::COL], static_cast<const Grid&>(*this), *m_binomial);
+    assert(m_model);
+    m_alternatives[Line::ROW].resize(height());
+    m_alternatives[Line::COL].resize(width());
+    m_line_states.resize(parent.m_line_states.size());
+    m_pass_worklist = std::vector<WorklistWord>(parent.m_pass_worklist.size(), 0u);
+
+    m_trail.m_enabled = m_solver_policy.m_nested_grid_trail;
+    m_trail.m_max_nb_tiles = width() * height() / TRAIL_MAX_RATIO;
+    m_trail.m_line_in_trail[Line::ROW].resize(height(), false);
+    m_trail.m_line_in_trail[Line::COL].resize(width(), false);
 }
 
 template <typename SolverPolicy>
 WorkGrid<SolverPolicy>& WorkGrid<SolverPolicy>::operator=(const WorkGrid& parent)
 {
     static_cast<Grid&>(*this) = static_cast<const Grid&>(parent);
-    std::for_each(m_alternatives[Line::ROW].begin(), m_alternatives[Line::ROW].end(), [](LineAlternatives& alt) { alt.reset(); });
-    std::for_each(m_alternatives[Line::COL].begin(), m_alternatives[Line::COL].end(), [](LineAlternatives& alt) { alt.reset(); });
-    m_line_completed[Line::ROW] = parent.m_line_completed[Line::ROW];
-    m_line_completed[Line::COL] = parent.m_line_completed[Line::COL];
-    m_line_has_updates[Line::ROW] = parent.m_line_has_updates[Line::ROW];
-    m_line_has_updates[Line::COL] = parent.m_line_has_updates[Line::COL];
-    m_line_is_fully_reduced[Line::ROW] = parent.m_line_is_fully_reduced[Line::ROW];
-    m_line_is_fully_reduced[Line::COL] = parent.m_line_is_fully_reduced[Line::COL];
-    m_line_probed[Line::ROW] = parent.m_line_probed[Line::ROW];
-    m_line_probed[Line::COL] = parent.m_line_probed[Line::COL];
-    m_nb_alternatives[Line::ROW] = parent.m_nb_alternatives[Line::ROW];
-    m_nb_alternatives[Line::COL] = parent.m_nb_alternatives[Line::COL];
+    std::for_each(m_alternatives[Line::ROW].begin(), m_alternatives[Line::ROW].end(), [](auto& alt) { if (alt) { alt->reset(); } });
+    std::for_each(m_alternatives[Line::COL].begin(), m_alternatives[Line::COL].end(), [](auto& alt) { if (alt) { alt->reset(); } });
+    copy_line_states_from(parent);
+    m_max_nb_alternatives = m_solver_policy.m_min_nb_alternatives;
+    m_probing_depth_incr = 0u;
+    m_trail.m_recording = m_trail.m_enabled;
+    m_trail.m_tiles.clear();
+    for (const LineId& line_id : m_trail.m_lines)
+        m_trail.m_line_in_trail[line_id.m_type][line_id.m_index] = false;
+    m_trail.m_lines.clear();
+    return *this;
+}
+
+// Revert the tiles and the lines modified since the last copy of the parent grid, instead of copying the whole state again.
+// The tiles are only ever set from unknown to empty or filled, and the alternatives of a line are only modified in
+// update_line(), therefore the trail is a list of tiles and a list of lines. The line states are copied in bulk.
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::undo_changes(const WorkGrid& parent)
+{
+    assert(m_trail.m_recording);
+    for (const auto& [x, y] : m_trail.m_tiles)
+    {
+        assert(parent.get(x, y) == Tile::UNKNOWN);
+        set(x, y, Tile::UNKNOWN);
+    }
+    m_trail.m_tiles.clear();
+    for (const LineId& line_id : m_trail.m_lines)
+    {
+        const auto type = line_id.m_type;
+        const auto index = line_id.m_index;
+        if (m_alternatives[type][index])
+            m_alternatives[type][index]->reset();
+        m_trail.m_line_in_trail[type][index] = false;
+    }
+    m_trail.m_lines.clear();
+    copy_line_states_from(parent);
+    m_max_nb_alternatives = m_solver_policy.m_min_nb_alternatives;
+    m_probing_depth_incr = 0u;
+    assert(is_same_state(parent));
+}
+
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::record_line_in_trail(Line::Type type, Line::Index index)
+{
+    if (m_trail.m_recording && !m_trail.m_line_in_trail[type][index])
+    {
+        m_trail.m_line_in_trail[type][index] = true;
+        m_trail.m_lines.emplace_back(type, index);
+    }
+}
+
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::record_tile_in_trail(Line::Index x, Line::Index y)
+{
+    if (!m_trail.m_recording)
+        return;
+    if (m_trail.m_tiles.size() < m_trail.m_max_nb_tiles)
+        m_trail.m_tiles.emplace_back(x, y);
+    else
+        m_trail.m_recording = false;    // Cheaper to copy the parent grid
+}
+
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::is_same_state(const WorkGrid& other) const
+{
+    return static_cast<const Grid&>(*this) == static_cast<const Grid&>(other)
+        && m_line_states == other.m_line_states
+        && std::equal(m_all_lines.cbegin(), AllLines::const_iterator(m_uncompleted_lines_end), other.m_all_lines.cbegin(), AllLines::const_iterator(other.m_uncompleted_lines_end),
+            [](const LineId& lhs, const LineId& rhs) { return lhs.m_type == rhs.m_type && lhs.m_index == rhs.m_index; });
+}
+
+// The line states, the order of the lines and the lines to reduce, copied as a whole
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::copy_line_states_from(const WorkGrid& parent)
+{
+    assert(!parent.m_pass_in_progress);
+    assert(m_line_states.size() == parent.m_line_states.size());
+    std::copy(parent.m_line_states.cbegin(), parent.m_line_states.cend(), m_line_states.begin());
     m_uncompleted_lines_range[Line::ROW] = parent.m_uncompleted_lines_range[Line::ROW];
     m_uncompleted_lines_range[Line::COL] = parent.m_uncompleted_lines_range[Line::COL];
-    m_all_lines = AllLines(parent.m_all_lines.cbegin(), AllLines::const_iterator(parent.m_uncompleted_lines_end));
+    m_all_lines.assign(parent.m_all_lines.cbegin(), AllLines::const_iterator(parent.m_uncompleted_lines_end));
     m_uncompleted_lines_end = m_all_lines.end();
-    m_max_nb_alternatives = SolverPolicy::MIN_NB_ALTERNATIVES;
-    m_probing_depth_incr = 0u;
-    return *this;
+    m_lines_to_reduce = parent.m_lines_to_reduce;
+    m_pass_in_progress = false;
+}
+
+// The alternatives of a line are built on first use, since the nested grids usually reduce only a fraction of the lines
+template <typename SolverPolicy>
+LineAlternatives& WorkGrid<SolverPolicy>::line_alternatives(Line::Type type, Line::Index index)
+{
+    auto& alternatives = m_alternatives[type][index];
+    if (!alternatives)
+        alternatives.emplace(m_model->constraint(type, index), get_line(type, index), *m_binomial);
+    return *alternatives;
+}
+
+// The enumerator of a line is shared by the nested grids. A line is complete in the nested grids of the one that
+// enumerates its alternatives, therefore the enumerator is never used twice at the same time.
+template <typename SolverPolicy>
+AlternativesEnumerator& WorkGrid<SolverPolicy>::alternatives_enumerator(LineId line_id)
+{
+    assert(!line_state(line_id).m_completed);
+    auto& enumerator = line_buffers(line_id.m_type, line_id.m_index).m_enumerator;
+    if (enumerator)
+        enumerator->reset(get_line(line_id));
+    else
+        enumerator.emplace(m_model->constraint(line_id.m_type, line_id.m_index), get_line(line_id));
+    return *enumerator;
 }
 
 template <typename SolverPolicy>
@@ -291,7 +473,7 @@ void WorkGrid<SolverPolicy>::set_stats(GridStats* stats)
     this->m_grid_stats = stats;
     if (stats)
     {
-        stats->max_k = m_max_k;
+        stats->max_k = m_model->max_nb_segments();
         stats->max_branching_depth = m_branching_depth;
     }
 }
@@ -432,7 +614,7 @@ Solver::Status WorkGrid<SolverPolicy>::solve(const Solver::SolutionFound& soluti
             }
 
             // Make a guess (branch search)
-            status = branch(solution_found);
+            status = use_parallel_branching() && start_thread_pool() ? parallel_branch(solution_found) : branch(solution_found);
         }
         else
         {
@@ -453,31 +635,31 @@ bool WorkGrid<SolverPolicy>::all_lines_completed() const
 {
     const bool all_completed = (m_all_lines.begin() == m_uncompleted_lines_end);
     assert(all_completed == [this]() -> bool {
-        const bool all_rows = std::all_of(std::cbegin(m_line_completed[Line::ROW]), std::cend(m_line_completed[Line::ROW]), [](bool b) { return b; });
-        const bool all_cols = std::all_of(std::cbegin(m_line_completed[Line::COL]), std::cend(m_line_completed[Line::COL]), [](bool b) { return b; });
-        return all_rows & all_cols;
+        return std::all_of(m_line_states.cbegin(), m_line_states.cend(), [](const LineState& state) { return state.m_completed; });
     }());
     return all_completed;
 }
 
 
 template <typename SolverPolicy>
-bool WorkGrid<SolverPolicy>::update_line(const LineSpan& line, unsigned int nb_alt)
+bool WorkGrid<SolverPolicy>::update_line(const LineSpan& line, LineAlternatives::NbAlt nb_alt)
 {
     assert(nb_alt > 0);
-    static const Line DEFAULT_LINE(Line::ROW, 0, 0);
     const auto line_type = line.type();
     const auto line_index = line.index();
     const auto line_sz = line.size();
-    const Line observer_original_line = m_observer ? line_from_line_span(get_line(line_type, line_index)) : DEFAULT_LINE;
-    const auto observer_original_nb_alt = m_nb_alternatives[line_type][line_index];
+    std::optional<Line> observer_original_line;
+    if (m_observer) { observer_original_line.emplace(line_from_line_span(get_line(line_type, line_index))); }
+    const auto observer_original_nb_alt = line_state(line_type, line_index).m_nb_alt;
     assert(line.size() == static_cast<unsigned int>(line.type() == Line::ROW ? width() : height()));
 
     bool line_changed = false;
-    const auto set_tile_func = [this, &line_changed](Line::Type type, Line::Index idx) {
-        m_line_has_updates[type][idx] = true;
-        // mark the impacted line or column as "to be reduced"
-        m_line_is_fully_reduced[type][idx] = false;
+    record_line_in_trail(line_type, line_index);
+    // The tiles set on the orthogonal lines depend on the same hypotheses as the known tiles of the line
+    const DecisionLevels decision_levels = line_state(line_type, line_index).m_decision_levels;
+    const auto set_tile_func = [this, &line_changed, decision_levels](Line::Type type, Line::Index idx) {
+        line_has_updates(type, idx);
+        line_state(type, idx).m_decision_levels |= decision_levels;
         line_changed = true;
     };
 
@@ -490,7 +672,10 @@ bool WorkGrid<SolverPolicy>::update_line(const LineSpan& line, unsigned int nb_a
             const bool tile_changed = update(tile_idx, line_index, line[static_cast<int>(tile_idx)]);
             line_is_complete &= (grid_line[static_cast<int>(tile_idx)] != Tile::UNKNOWN);
             if (tile_changed)
+            {
                 set_tile_func(Line::COL, tile_idx);
+                record_tile_in_trail(tile_idx, line_index);
+            }
         }
     }
     else
@@ -501,13 +686,22 @@ bool WorkGrid<SolverPolicy>::update_line(const LineSpan& line, unsigned int nb_a
             const bool tile_changed = update(line_index, tile_idx, line[static_cast<int>(tile_idx)]);
             line_is_complete &= (grid_line[static_cast<int>(tile_idx)] != Tile::UNKNOWN);
             if (tile_changed)
+            {
                 set_tile_func(Line::ROW, tile_idx);
+                record_tile_in_trail(line_index, tile_idx);
+            }
         }
     }
 
-    m_nb_alternatives[line_type][line_index] = nb_alt = line_is_complete ? 1u : nb_alt;
-    m_line_completed[line_type][line_index] = line_is_complete;
-    m_line_has_updates[line_type][line_index] = line_changed;
+    LineState& state = line_state(line_type, line_index);
+    nb_alt = line_is_complete ? 1u : nb_alt;
+    if (state.m_nb_alt != nb_alt)
+    {
+        state.m_nb_alt = nb_alt;
+        state.m_nb_alt_changed = true;
+    }
+    state.m_completed = line_is_complete;
+    state.m_has_updates = line_changed;
 
     if (m_observer)
     {
@@ -516,16 +710,16 @@ bool WorkGrid<SolverPolicy>::update_line(const LineSpan& line, unsigned int nb_a
 
         if (line_changed)
         {
-            data.m_misc_i = observer_original_nb_alt;
-            m_observer(ObserverEvent::KNOWN_LINE, &observer_original_line, data);
-            const Line delta = get_line(line_type, line_index) - observer_original_line;
-            data.m_misc_i = nb_alt;
+            data.m_misc_i = observer_nb_alternatives(observer_original_nb_alt);
+            m_observer(ObserverEvent::KNOWN_LINE, &*observer_original_line, data);
+            const Line delta = get_line(line_type, line_index) - *observer_original_line;
+            data.m_misc_i = observer_nb_alternatives(nb_alt);
             m_observer(ObserverEvent::DELTA_LINE, &delta, data);
         }
         else
         {
-            data.m_misc_i = nb_alt;
-            m_observer(ObserverEvent::KNOWN_LINE, &observer_original_line, data);
+            data.m_misc_i = observer_nb_alternatives(nb_alt);
+            m_observer(ObserverEvent::KNOWN_LINE, &*observer_original_line, data);
         }
     }
 
@@ -533,18 +727,72 @@ bool WorkGrid<SolverPolicy>::update_line(const LineSpan& line, unsigned int nb_a
 }
 
 
+// A tile of the line was set
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::line_has_updates(Line::Type type, Line::Index index)
+{
+    record_line_in_trail(type, index);
+    line_state(type, index).m_has_updates = true;
+    // mark the impacted line or column as "to be reduced"
+    schedule_line_reduction(type, index);
+}
+
+// Add a line to the lines to reduce. If a pass is in progress and the line comes after the current one in m_all_lines,
+// it is reduced during the same pass, as it would be by an iteration over m_all_lines.
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::schedule_line_reduction(Line::Type type, Line::Index index)
+{
+    LineState& state = line_state(type, index);
+    state.m_fully_reduced = false;
+    if (state.m_to_reduce)
+        return;
+    state.m_to_reduce = true;
+    if (m_pass_in_progress && !state.m_completed && state.m_rank > m_pass_rank)
+        m_pass_worklist[state.m_rank / WORKLIST_WORD_BITS] |= WorklistWord{1} << (state.m_rank % WORKLIST_WORD_BITS);
+    else
+        m_lines_to_reduce.emplace_back(type, index);
+}
+
+// The completed lines are swapped with the uncompleted ones at the end of the range. The latter are then out of order,
+// therefore they are flagged to be sorted again by sort_by_nb_alternatives().
 template <typename SolverPolicy>
 void WorkGrid<SolverPolicy>::partition_completed_lines()
 {
-    m_uncompleted_lines_end = std::partition(m_all_lines.begin(), m_uncompleted_lines_end, [this](const LineId id) { return !m_line_completed[id.m_type][id.m_index]; });
-    update_line_range<true>(m_uncompleted_lines_range[Line::ROW], m_line_completed[Line::ROW]);
-    update_line_range<true>(m_uncompleted_lines_range[Line::COL], m_line_completed[Line::COL]);
+    auto first = m_all_lines.begin();
+    auto last = m_uncompleted_lines_end;
+    while (true)
+    {
+        while (first != last && !line_state(*first).m_completed)
+            ++first;
+        if (first == last)
+            break;
+        --last;
+        while (first != last && line_state(*last).m_completed)
+            --last;
+        if (first == last)
+            break;
+        line_state(*last).m_nb_alt_changed = true;
+        std::iter_swap(first, last);
+        ++first;
+    }
+    m_uncompleted_lines_end = first;
+    for (const auto type : { Line::ROW, Line::COL })
+        update_line_range<true>(m_uncompleted_lines_range[type], type == Line::ROW ? height() : width(), [this, type](Line::Index index) { return line_state(type, index).m_completed; });
+    update_line_ranks();
+}
+
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::update_line_ranks()
+{
+    unsigned int rank = 0u;
+    for (auto it = m_all_lines.begin(); it != m_uncompleted_lines_end; ++it)
+        line_state(*it).m_rank = rank++;
 }
 
 template <typename SolverPolicy>
-std::vector<LineId> WorkGrid<SolverPolicy>::sorted_edges() const
+void WorkGrid<SolverPolicy>::sorted_edges(AllLines& lines) const
 {
-    std::vector<LineId> lines;
+    lines.clear();
     for (const auto line_type : { Line::ROW, Line::COL })
     {
         if (!m_uncompleted_lines_range[line_type].empty())
@@ -559,16 +807,14 @@ std::vector<LineId> WorkGrid<SolverPolicy>::sorted_edges() const
     }
 
     std::sort(lines.begin(), lines.end(), [this](const auto& lhs, const auto& rhs) {
-        return m_nb_alternatives[lhs.m_type][lhs.m_index] < m_nb_alternatives[rhs.m_type][rhs.m_index];
+        return line_state(lhs).m_nb_alt < line_state(rhs).m_nb_alt;
     });
-
-    return lines;
 }
 
 template <typename SolverPolicy>
-std::vector<LineId> WorkGrid<SolverPolicy>::sorted_lines_next_to_completed() const
+void WorkGrid<SolverPolicy>::sorted_lines_next_to_completed(AllLines& lines) const
 {
-    std::vector<LineId> lines;
+    lines.clear();
     for (const auto line_type : { Line::ROW, Line::COL })
     {
         if (!m_uncompleted_lines_range[line_type].empty())
@@ -581,8 +827,8 @@ std::vector<LineId> WorkGrid<SolverPolicy>::sorted_lines_next_to_completed() con
                 lines.emplace_back(line_type, last);
             for (Line::Index idx = first + 1; idx < last; idx++)
             {
-                if (!m_line_completed[line_type][idx] &&
-                    (m_line_completed[line_type][idx - 1] || m_line_completed[line_type][idx + 1]))
+                if (!line_state(line_type, idx).m_completed &&
+                    (line_state(line_type, idx - 1).m_completed || line_state(line_type, idx + 1).m_completed))
                 {
                     lines.emplace_back(LineId(line_type, idx));
                 }
@@ -591,19 +837,50 @@ std::vector<LineId> WorkGrid<SolverPolicy>::sorted_lines_next_to_completed() con
     }
 
     std::sort(lines.begin(), lines.end(), [this](const auto& lhs, const auto& rhs) {
-        return m_nb_alternatives[lhs.m_type][lhs.m_index] < m_nb_alternatives[rhs.m_type][rhs.m_index];
+        return line_state(lhs).m_nb_alt < line_state(rhs).m_nb_alt;
     });
-
-    return lines;
 }
 
 
+// Only the lines of which the number of alternatives has changed since the last call are sorted, then they are merged
+// with the other lines, which are still in order.
 template <typename SolverPolicy>
 void WorkGrid<SolverPolicy>::sort_by_nb_alternatives()
 {
-    std::sort(m_all_lines.begin(), m_uncompleted_lines_end, [this](const auto& lhs, const auto& rhs) {
-        return m_nb_alternatives[lhs.m_type][lhs.m_index] < m_nb_alternatives[rhs.m_type][rhs.m_index];
-    });
+    const auto less = [this](const LineId& lhs, const LineId& rhs) {
+        return line_state(lhs).m_nb_alt < line_state(rhs).m_nb_alt;
+    };
+    m_lines_buffer.clear();
+    auto unchanged_end = m_all_lines.begin();
+    for (auto it = m_all_lines.begin(); it != m_uncompleted_lines_end; ++it)
+    {
+        if (line_state(*it).m_nb_alt_changed)
+        {
+            line_state(*it).m_nb_alt_changed = false;
+            m_lines_buffer.push_back(*it);
+        }
+        else
+        {
+            *unchanged_end++ = *it;
+        }
+    }
+    if (m_lines_buffer.empty())
+        return;
+    std::sort(m_lines_buffer.begin(), m_lines_buffer.end(), less);
+
+    // Merge backward, in place
+    auto out = m_uncompleted_lines_end;
+    auto changed_end = m_lines_buffer.end();
+    while (changed_end != m_lines_buffer.begin())
+    {
+        if (unchanged_end != m_all_lines.begin() && less(*(changed_end - 1), *(unchanged_end - 1)))
+            *--out = *--unchanged_end;
+        else
+            *--out = *--changed_end;
+    }
+    assert(out == unchanged_end);
+    assert(is_sorted_by_nb_alternatives());
+    update_line_ranks();
 }
 
 
@@ -611,16 +888,56 @@ template <typename SolverPolicy>
 bool WorkGrid<SolverPolicy>::is_sorted_by_nb_alternatives() const
 {
     return std::is_sorted(m_all_lines.cbegin(), AllLines::const_iterator(m_uncompleted_lines_end), [this](const auto& lhs, const auto& rhs) {
-        return m_nb_alternatives[lhs.m_type][lhs.m_index] < m_nb_alternatives[rhs.m_type][rhs.m_index];
+        return line_state(lhs).m_nb_alt < line_state(rhs).m_nb_alt;
     });
 }
 
 
+// The front of m_all_lines is the line with the fewest alternatives. The other heuristics only select a line that is fully
+// reduced, and fall back on that one.
 template <typename SolverPolicy>
-LineId WorkGrid<SolverPolicy>::next_line_for_search() const
+LineId WorkGrid<SolverPolicy>::next_line_for_search()
 {
     assert(is_sorted_by_nb_alternatives());
-    return m_all_lines.front();
+    LineId search_line = m_all_lines.front();
+    bool heuristic_choice = false;
+    switch (m_solver_policy.m_branching_heuristic)
+    {
+    case BranchingHeuristic::FEWEST_ALTERNATIVES:
+        break;
+    case BranchingHeuristic::NEXT_TO_COMPLETED:
+    {
+        sorted_lines_next_to_completed(m_lines_buffer);
+        const auto it = std::find_if(m_lines_buffer.cbegin(), m_lines_buffer.cend(), [this](const LineId& line_id) { return line_state(line_id).m_fully_reduced; });
+        if (it != m_lines_buffer.cend() && line_state(*it).m_rank != 0u)
+        {
+            search_line = *it;
+            heuristic_choice = true;
+        }
+        break;
+    }
+    case BranchingHeuristic::ACTIVITY:
+    {
+        assert(m_line_activity);
+        double max_activity = m_line_activity->activity(search_line);
+        const auto nb_candidates = std::min(static_cast<std::ptrdiff_t>(SolverPolicy::BRANCHING_ACTIVITY_NB_CANDIDATE_LINES), m_uncompleted_lines_end - m_all_lines.begin());
+        for (auto it = m_all_lines.begin() + 1; it < m_all_lines.begin() + nb_candidates; ++it)
+        {
+            const double activity = m_line_activity->activity(*it);
+            if (activity > max_activity && line_state(*it).m_fully_reduced)
+            {
+                max_activity = activity;
+                search_line = *it;
+                heuristic_choice = true;
+            }
+        }
+        break;
+    }
+    default:
+        assert(0);
+    }
+    if (heuristic_choice && m_grid_stats != nullptr) { m_grid_stats->nb_branching_heuristic_choices++; }
+    return search_line;
 }
 
 
@@ -628,7 +945,7 @@ template <typename SolverPolicy>
 typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::single_line_initial_pass(Line::Type type, unsigned int index)
 {
     PassStatus status;
-    const LineConstraint& constraint = m_constraints[type].at(index);
+    const LineConstraint& constraint = m_model->constraint(type, index);
 
     const auto line_size = static_cast<unsigned int>(type == Line::ROW ? width() : height());
 
@@ -661,36 +978,57 @@ template <typename SolverPolicy>
 typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::single_line_linear_reduction(Line::Type type, unsigned int index)
 {
     PassStatus status;
+    LineState& state = line_state(type, index);
 
-    if (m_line_is_fully_reduced[type][index] || !m_line_has_updates[type][index])
+    if (state.m_fully_reduced || !state.m_has_updates)
     {
         return status;
     }
 
-    // Reduce all possible lines that match the data already present in the grid and the line constraint
+    assert(m_arena);
+    linear_reduction(type, index, *m_arena);
+    return apply_linear_reduction(type, index);
+}
+
+
+// Reduce all possible lines that match the data already present in the grid and the line constraint.
+// The result is stored in the line buffers, and the grid is not modified.
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::linear_reduction(Line::Type type, unsigned int index, Arena& arena)
+{
+    Arena::Scope arena_scope(arena);
+    line_alternatives(type, index).linear_reduction(line_buffers(type, index).m_reduction, &arena);
+}
+
+
+template <typename SolverPolicy>
+typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::apply_linear_reduction(Line::Type type, unsigned int index)
+{
+    PassStatus status;
+    LineState& state = line_state(type, index);
+    const LineAlternatives::Reduction& reduction = line_buffers(type, index).m_reduction;
     if (m_grid_stats != nullptr) { m_grid_stats->nb_single_line_linear_reduction++; }
-    const auto linear_reduction = m_alternatives[type][index].linear_reduction();
 
     // If the list of alternative lines is empty, it means the grid data is contradictory
-    if (linear_reduction.nb_alternatives == 0)
+    if (reduction.nb_alternatives == 0)
     {
         status.contradictory = true;
         return status;
     }
-    if (m_grid_stats != nullptr) { m_grid_stats->max_nb_alternatives_linear = std::max(m_grid_stats->max_nb_alternatives_linear, linear_reduction.nb_alternatives); }
+    if (m_grid_stats != nullptr) { m_grid_stats->max_nb_alternatives_linear = std::max(m_grid_stats->max_nb_alternatives_linear, reduction.nb_alternatives); }
 
     // In any case, update the grid data with the reduced line resulting from the list of alternatives
-    const auto nb_alternatives = std::min(linear_reduction.nb_alternatives, m_nb_alternatives[type][index]);
-    const bool line_changed = status.grid_changed = update_line(linear_reduction.reduced_line, nb_alternatives);
+    const auto nb_alternatives = std::min(reduction.nb_alternatives, state.m_nb_alt);
+    const bool line_changed = status.grid_changed = update_line(reduction.reduced_line, nb_alternatives);
     if (line_changed)
-        m_line_is_fully_reduced[type][index] = false;
-    if (linear_reduction.is_fully_reduced)
-        m_line_is_fully_reduced[type][index] = true;
+        state.m_fully_reduced = false;
+    if (reduction.is_fully_reduced)
+        state.m_fully_reduced = true;
 
     if (m_grid_stats != nullptr && line_changed)
     {
         m_grid_stats->nb_single_line_linear_reduction_w_change++;
-        m_grid_stats->max_nb_alternatives_linear_w_change = std::max(m_grid_stats->max_nb_alternatives_linear_w_change, linear_reduction.nb_alternatives);
+        m_grid_stats->max_nb_alternatives_linear_w_change = std::max(m_grid_stats->max_nb_alternatives_linear_w_change, reduction.nb_alternatives);
     }
 
     return status;
@@ -701,173 +1039,476 @@ template <typename SolverPolicy>
 typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::single_line_full_reduction(Line::Type type, unsigned int index)
 {
     PassStatus status;
+    LineState& state = line_state(type, index);
 
-    if (m_line_is_fully_reduced[type][index] || m_nb_alternatives[type][index] > m_max_nb_alternatives)
+    if (state.m_fully_reduced || state.m_nb_alt > m_max_nb_alternatives)
     {
-        if (!m_line_is_fully_reduced[type][index])
+        if (!state.m_fully_reduced)
             status.skipped_lines++;
         return status;
     }
 
-    // Reduce all possible lines that match the data already present in the grid and the line constraint
-    if (m_grid_stats != nullptr) { m_grid_stats->nb_single_line_full_reduction++; }
     assert(m_full_reduction_buffers);
-    const auto full_reduction = m_alternatives[type][index].full_reduction(m_full_reduction_buffers.get());
+    const bool cache_hit = full_reduction(type, index, *m_full_reduction_buffers, m_automaton_buffers.get());
+    return apply_full_reduction(type, index, cache_hit);
+}
+
+
+// Reduce all possible lines that match the data already present in the grid and the line constraint, or read the
+// reduction from the cache. The result is stored in the line buffers, and the grid, the cache and the stats are not
+// modified. Return true if the reduction was found in the cache.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::full_reduction(Line::Type type, unsigned int index, FullReductionBuffers& buffers, LineAutomaton::Buffers* automaton_buffers)
+{
+    LineAlternatives::Reduction& result = line_buffers(type, index).m_reduction;
+    const LineSpan known_tiles = get_line(type, index);
+    if (read_reduction_cache(result, known_tiles))
+        return true;
+    if (use_line_automaton(type, index))
+    {
+        assert(automaton_buffers);
+        m_model->automaton(type, index).full_reduction(result, known_tiles, *automaton_buffers);
+    }
+    else
+    {
+        line_alternatives(type, index).full_reduction(result, &buffers);
+    }
+    return false;
+}
+
+
+template <typename SolverPolicy>
+typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::apply_full_reduction(Line::Type type, unsigned int index, bool cache_hit)
+{
+    PassStatus status;
+    LineState& state = line_state(type, index);
+    const LineAlternatives::Reduction& reduction = line_buffers(type, index).m_reduction;
+    if (m_grid_stats != nullptr)
+    {
+        m_grid_stats->nb_single_line_full_reduction++;
+        if constexpr (SolverPolicy::REDUCTION_CACHE_ENABLED)
+        {
+            if (cache_hit)
+                m_grid_stats->nb_reduction_cache_hits++;
+            else
+                m_grid_stats->nb_reduction_cache_misses++;
+        }
+    }
+    if (!cache_hit)
+        store_reduction_cache(get_line(type, index), reduction);
 
     // If the list of alternative lines is empty, it means the grid data is contradictory
-    if (full_reduction.nb_alternatives == 0)
+    if (reduction.nb_alternatives == 0)
     {
         status.contradictory = true;
         return status;
     }
-    if (m_grid_stats != nullptr) { m_grid_stats->max_nb_alternatives_full = std::max(m_grid_stats->max_nb_alternatives_full, full_reduction.nb_alternatives); }
+    if (m_grid_stats != nullptr) { m_grid_stats->max_nb_alternatives_full = std::max(m_grid_stats->max_nb_alternatives_full, reduction.nb_alternatives); }
 
     // In any case, update the grid data with the reduced line resulting from the list of alternatives
-    status.grid_changed = update_line(full_reduction.reduced_line, full_reduction.nb_alternatives);
+    status.grid_changed = update_line(reduction.reduced_line, reduction.nb_alternatives);
 
-    assert(full_reduction.is_fully_reduced);
-    m_line_is_fully_reduced[type][index] = true;
+    assert(reduction.is_fully_reduced);
+    state.m_fully_reduced = true;
 
     if (m_grid_stats != nullptr && status.grid_changed)
     {
         m_grid_stats->nb_single_line_full_reduction_w_change++;
-        m_grid_stats->max_nb_alternatives_full_w_change = std::max(m_grid_stats->max_nb_alternatives_full_w_change, full_reduction.nb_alternatives);
+        m_grid_stats->max_nb_alternatives_full_w_change = std::max(m_grid_stats->max_nb_alternatives_full_w_change, reduction.nb_alternatives);
     }
 
     return status;
 }
 
 
-// Reduce all columns and all rows. Return false if no change was made on the grid.
-// Return true if the grid was changed during the full pass
 template <typename SolverPolicy>
-template <WorkGridState S>
-typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::full_grid_pass()
+bool WorkGrid<SolverPolicy>::use_line_automaton(Line::Type type, unsigned int index) const
 {
-    PassStatus status;
-    if (m_grid_stats != nullptr) { m_grid_stats->nb_full_grid_pass++; }
+    switch (m_solver_policy.m_line_solver_engine)
+    {
+    case LineSolverEngine::LINE_ALTERNATIVES:
+        return false;
+    case LineSolverEngine::AUTOMATON:
+        return true;
+    case LineSolverEngine::AUTO:
+    default:
+        return m_model->automaton(type, index).nb_words() == 1u;
+    }
+}
 
-    for (auto it = m_all_lines.begin(); it != m_uncompleted_lines_end; ++it)
+
+// The reduction cache is shared by the nested work grids. The reduction is deterministic given the line constraint and
+// the known tiles, which are the key of the cache.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::read_reduction_cache(LineAlternatives::Reduction& result, const LineSpan& known_tiles) const
+{
+    if constexpr (SolverPolicy::REDUCTION_CACHE_ENABLED)
     {
-        if (m_line_completed[it->m_type][it->m_index])
-            continue;
-        if constexpr (S == WorkGridState::INITIAL_PASS)
-        {
-            status += single_line_initial_pass(it->m_type, it->m_index);
-        }
-        else if constexpr (S == WorkGridState::LINEAR_REDUCTION)
+        assert(m_reduction_cache);
+        if (const auto entry = m_reduction_cache->read_line(known_tiles))
         {
-            status += single_line_linear_reduction(it->m_type, it->m_index);
+            copy_line_span(result.reduced_line, entry->m_reduced_line);
+            result.nb_alternatives = entry->m_nb_alt;
+            result.is_fully_reduced = true;
+            return true;
         }
+    }
+    return false;
+}
+
+
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::store_reduction_cache(const LineSpan& known_tiles, const LineAlternatives::Reduction& reduction)
+{
+    if constexpr (SolverPolicy::REDUCTION_CACHE_ENABLED)
+    {
+        assert(m_reduction_cache);
+        m_reduction_cache->store_line(known_tiles, reduction.reduced_line, reduction.nb_alternatives);
+    }
+}
+
+
+// Full reduction of a line, looked up first in the reduction cache
+template <typename SolverPolicy>
+template <typename Reduce>
+void WorkGrid<SolverPolicy>::full_reduction_with_cache(LineAlternatives::Reduction& result, const LineSpan& known_tiles, Reduce reduce)
+{
+    const bool cache_hit = read_reduction_cache(result, known_tiles);
+    if (m_grid_stats != nullptr && SolverPolicy::REDUCTION_CACHE_ENABLED)
+    {
+        if (cache_hit)
+            m_grid_stats->nb_reduction_cache_hits++;
         else
-        {
-            static_assert(S == WorkGridState::FULL_REDUCTION);
-            status += single_line_full_reduction(it->m_type, it->m_index);
-        }
-        if (status.contradictory)
-        {
-            if (m_observer)
-            {
-                ObserverData data;
-                data.m_depth = m_branching_depth;
-                const Line contradictory_line = line_from_line_span(get_line(*it));
-                m_observer(ObserverEvent::KNOWN_LINE, &contradictory_line, data);
-            }
-            break;
-        }
-        if (m_abort_function && m_abort_function())
-            throw PicrossSolverAborted();
+            m_grid_stats->nb_reduction_cache_misses++;
     }
-    if constexpr (S == WorkGridState::INITIAL_PASS)
+    if (!cache_hit)
     {
-        for (auto it = m_all_lines.begin(); it != m_uncompleted_lines_end; ++it)
-            m_line_has_updates[it->m_type][it->m_index] = true;
+        reduce(result);
+        store_reduction_cache(known_tiles, result);
     }
-    partition_completed_lines();
-    sort_by_nb_alternatives();
-    return status;
 }
 
-// This method probes at least one line of the grid. It returns true if the grid has changed, false otherwise.
-// To prevent repeat of the found solutions, if the grid is solved during the probing, the found solution is not saved.
 template <typename SolverPolicy>
-typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe()
+template <WorkGridState S>
+typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::single_line_pass(LineId line_id)
 {
-    assert(m_solver_policy.m_branching_allowed);
-    ProbingResult result{};
-    std::vector<LineId> candidate_lines;
-    const auto edges = sorted_edges();
-    for (const LineId& edge : edges)
+    PassStatus status;
+    if constexpr (S == WorkGridState::INITIAL_PASS)
     {
-        if (m_nb_alternatives[edge.m_type][edge.m_index] < m_solver_policy.m_max_nb_alternatives_probing_edge)
-        {
-            candidate_lines.emplace_back(edge);
-        }
+        status = single_line_initial_pass(line_id.m_type, line_id.m_index);
     }
-    assert(is_sorted_by_nb_alternatives());
-    for (auto idx = 0u; idx < m_solver_policy.m_nb_of_lines_for_probing_round && idx < m_all_lines.size(); idx++)
+    else if constexpr (S == WorkGridState::LINEAR_REDUCTION)
     {
-        const LineId& line_id = m_all_lines[idx];
-        if (!m_line_completed[line_id.m_type][line_id.m_index] &&
-            m_nb_alternatives[line_id.m_type][line_id.m_index] < m_solver_policy.m_max_nb_alternatives_probing_other)
-        {
-            candidate_lines.emplace_back(line_id);
-        }
+        status = single_line_linear_reduction(line_id.m_type, line_id.m_index);
     }
-    for (auto candidate : candidate_lines)
+    else
     {
-        if (!m_line_probed[candidate.m_type][candidate.m_index])
-        {
-            result = probe(candidate);
-            switch (result.m_status)
-            {
-            case Solver::Status::OK:
-                break;
+        static_assert(S == WorkGridState::FULL_REDUCTION);
+        status = single_line_full_reduction(line_id.m_type, line_id.m_index);
+    }
+    end_single_line_pass(line_id, status);
+    return status;
+}
 
-            case Solver::Status::ABORTED:
-            case Solver::Status::CONTRADICTORY_GRID:
-                return result;
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::end_single_line_pass(LineId line_id, const PassStatus& status)
+{
+    if (status.contradictory)
+        m_conflict_levels = line_state(line_id).m_decision_levels;
+    if (status.contradictory && m_line_activity)
+        bump_conflict_lines(line_id);
+    if (status.contradictory && m_observer)
+    {
+        ObserverData data;
+        data.m_depth = m_branching_depth;
+        const Line contradictory_line = line_from_line_span(get_line(line_id));
+        m_observer(ObserverEvent::KNOWN_LINE, &contradictory_line, data);
+    }
+    if (!status.contradictory && is_aborted())
+        throw PicrossSolverAborted();
+}
 
-            case Solver::Status::NOT_LINE_SOLVABLE:
-            default:
-                assert(0);
-                break;
-            }
-            if (result.m_grid_has_changed)
+// Bump the activity of the contradictory line, and of the lines of the hypotheses in the conflict set
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::bump_conflict_lines(LineId contradictory_line_id)
+{
+    assert(m_line_activity);
+    unsigned int nb_bumps = 1u;
+    m_line_activity->bump(contradictory_line_id);
+    for (const auto type : { Line::ROW, Line::COL })
+    {
+        const auto nb_lines = static_cast<Line::Index>(type == Line::ROW ? height() : width());
+        for (Line::Index index = 0u; index < nb_lines; index++)
+        {
+            if (type == contradictory_line_id.m_type && index == contradictory_line_id.m_index)
+                continue;
+            const unsigned int depth = line_state(type, index).m_decision_depth;
+            if (depth > 0u && (m_conflict_levels & decision_level_bit(depth)) != 0u)
             {
-                result.m_continue_probing = true;
-                m_probing_depth_incr = 1u;
-                break;
+                m_line_activity->bump(LineId(type, index));
+                nb_bumps++;
             }
         }
     }
-    return result;
+    m_line_activity->decay();
+    if (m_grid_stats != nullptr) { m_grid_stats->nb_line_activity_bumps += nb_bumps; }
 }
 
-// This method probes a specific line. It returns true if the grid was changed, false otherwise
 template <typename SolverPolicy>
-typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe(LineId line_id)
+bool WorkGrid<SolverPolicy>::is_aborted() const
 {
-    ProbingResult result{};
-    assert(m_line_is_fully_reduced[line_id.m_type][line_id.m_index]);
+    if (m_parallel_search == nullptr)
+        return m_abort_function && m_abort_function();
 
-    const LineConstraint& line_constraint = m_constraints[line_id.m_type][line_id.m_index];
-    const LineSpan known_tiles = get_line(line_id.m_type, line_id.m_index);
+    // In the parallel search, the abort function is called by one worker at a time
+    ParallelSearch& search = *m_parallel_search;
+    if (search.m_abort_function && !search.m_stop.load(std::memory_order_relaxed))
+    {
+        std::unique_lock<std::mutex> lock(search.m_abort_mutex, std::try_to_lock);
+        if (lock.owns_lock() && search.m_abort_function())
+            search.m_stop.store(true, std::memory_order_relaxed);
+    }
+    return search.m_stop.load(std::memory_order_relaxed);
+}
+
+// Reduce all columns and all rows. Return false if no change was made on the grid.
+// Return true if the grid was changed during the full pass
+template <typename SolverPolicy>
+template <WorkGridState S>
+typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::full_grid_pass()
+{
+    PassStatus status;
+    if (m_grid_stats != nullptr) { m_grid_stats->nb_full_grid_pass++; }
+
+    if constexpr (S == WorkGridState::INITIAL_PASS)
+    {
+        for (auto it = m_all_lines.begin(); it != m_uncompleted_lines_end; ++it)
+        {
+            if (line_state(*it).m_completed)
+                continue;
+            status += single_line_pass<S>(*it);
+            if (status.contradictory)
+                break;
+        }
+        for (auto it = m_all_lines.begin(); it != m_uncompleted_lines_end; ++it)
+            line_state(*it).m_has_updates = true;
+    }
+    else if (m_parallel_pass && !m_thread_pool->is_running() && m_lines_to_reduce.size() >= m_solver_policy.m_min_nb_lines_parallel_pass)
+    {
+        status = parallel_grid_pass<S>();
+    }
+    else
+    {
+        // Only visit the lines that are not fully reduced, in the order of m_all_lines. The lines updated during the pass
+        // are added to the worklist if they come after the current line, otherwise they are reduced during the next pass.
+        for (const LineId& line_id : m_lines_to_reduce)
+        {
+            LineState& state = line_state(line_id);
+            if (state.m_completed || state.m_fully_reduced)
+                state.m_to_reduce = false;
+            else
+                m_pass_worklist[state.m_rank / WORKLIST_WORD_BITS] |= WorklistWord{1} << (state.m_rank % WORKLIST_WORD_BITS);
+        }
+        m_lines_to_reduce.clear();
+        m_pass_in_progress = true;
+        for (std::size_t w = 0u; w < m_pass_worklist.size(); w++)
+        {
+            for (; m_pass_worklist[w] != 0u; m_pass_worklist[w] &= m_pass_worklist[w] - 1u)
+            {
+                m_pass_rank = static_cast<unsigned int>(w * WORKLIST_WORD_BITS + lowest_bit(m_pass_worklist[w]));
+                const LineId line_id = m_all_lines[m_pass_rank];
+                LineState& state = line_state(line_id);
+                assert(state.m_rank == m_pass_rank);
+                if (status.contradictory)
+                {
+                    // Stop reducing, but keep track of the remaining lines
+                    m_lines_to_reduce.push_back(line_id);
+                    continue;
+                }
+                if (!state.m_completed)
+                    status += single_line_pass<S>(line_id);
+                if (state.m_completed || state.m_fully_reduced)
+                    state.m_to_reduce = false;
+                else
+                    m_lines_to_reduce.push_back(line_id);
+            }
+        }
+        m_pass_in_progress = false;
+    }
+    partition_completed_lines();
+    sort_by_nb_alternatives();
+    return status;
+}
+
+// Reduce the rows concurrently, then the columns. The reduction of a row only reads the tiles of that row, and is
+// stored in the buffers of that row, therefore the rows are reduced independently from each other. The grid is then
+// updated with the reductions of the rows in a sequential step, which schedules the reduction of the columns. The same
+// goes for the columns. The rows updated by the reduction of the columns are reduced during the next pass.
+template <typename SolverPolicy>
+template <WorkGridState S>
+typename WorkGrid<SolverPolicy>::PassStatus WorkGrid<SolverPolicy>::parallel_grid_pass()
+{
+    static_assert(S == WorkGridState::LINEAR_REDUCTION || S == WorkGridState::FULL_REDUCTION);
+    assert(m_parallel_pass);
+    assert(!m_pass_in_progress);
+    PassStatus status;
+    AllLines& lines = m_parallel_pass->m_lines;
+    std::vector<char>& cache_hits = m_parallel_pass->m_cache_hits;
+    for (const auto type : { Line::ROW, Line::COL })
+    {
+        if (status.contradictory)
+            break;
+
+        // Take the lines of that type out of m_lines_to_reduce
+        lines.clear();
+        auto kept_end = m_lines_to_reduce.begin();
+        for (const LineId& line_id : m_lines_to_reduce)
+        {
+            LineState& state = line_state(line_id);
+            if (state.m_completed || state.m_fully_reduced)
+                state.m_to_reduce = false;
+            else if (line_id.m_type == type)
+                lines.push_back(line_id);
+            else
+                *kept_end++ = line_id;
+        }
+        m_lines_to_reduce.erase(kept_end, m_lines_to_reduce.end());
+
+        // Lines skipped by the reduction, as in single_line_linear_reduction() and single_line_full_reduction()
+        const auto skip_line = [this](const LineId& line_id) {
+            const LineState& state = line_state(line_id);
+            if constexpr (S == WorkGridState::LINEAR_REDUCTION)
+                return !state.m_has_updates;
+            else
+                return state.m_nb_alt > m_max_nb_alternatives;
+        };
+        const auto lines_to_reduce_end = std::stable_partition(lines.begin(), lines.end(), [&skip_line](const LineId& line_id) { return !skip_line(line_id); });
+        const auto nb_lines_to_reduce = static_cast<std::size_t>(std::distance(lines.begin(), lines_to_reduce_end));
+        if constexpr (S == WorkGridState::FULL_REDUCTION)
+            status.skipped_lines += static_cast<unsigned int>(lines.size() - nb_lines_to_reduce);
+
+        // Concurrent reduction
+        cache_hits.assign(nb_lines_to_reduce, 0);
+        auto reduce_line = [this, &lines, &cache_hits](std::size_t idx, unsigned int thread_idx) {
+            const LineId line_id = lines[idx];
+            ThreadBuffers& buffers = *m_parallel_pass->m_thread_buffers[thread_idx];
+            if constexpr (S == WorkGridState::LINEAR_REDUCTION)
+                linear_reduction(line_id.m_type, line_id.m_index, buffers.m_arena);
+            else
+                cache_hits[idx] = full_reduction(line_id.m_type, line_id.m_index, buffers.m_full_reduction, &buffers.m_automaton) ? 1 : 0;
+        };
+        m_thread_pool->parallel_for(nb_lines_to_reduce, reduce_line);
+
+        // Sequential update of the grid
+        for (std::size_t idx = 0u; idx < lines.size(); idx++)
+        {
+            const LineId line_id = lines[idx];
+            LineState& state = line_state(line_id);
+            if (idx < nb_lines_to_reduce && !status.contradictory)
+            {
+                PassStatus line_status;
+                if constexpr (S == WorkGridState::LINEAR_REDUCTION)
+                    line_status = apply_linear_reduction(line_id.m_type, line_id.m_index);
+                else
+                    line_status = apply_full_reduction(line_id.m_type, line_id.m_index, cache_hits[idx] != 0);
+                end_single_line_pass(line_id, line_status);
+                status += line_status;
+            }
+            if (state.m_completed || state.m_fully_reduced)
+                state.m_to_reduce = false;
+            else
+                m_lines_to_reduce.push_back(line_id);
+        }
+    }
+    return status;
+}
+
+// This method probes at least one line of the grid. It returns true if the grid has changed, false otherwise.
+// To prevent repeat of the found solutions, if the grid is solved during the probing, the found solution is not saved.
+template <typename SolverPolicy>
+typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe()
+{
+    assert(m_solver_policy.m_branching_allowed);
+    ProbingResult result{};
+    AllLines& candidate_lines = m_probing_candidates;
+    sorted_edges(candidate_lines);
+    candidate_lines.erase(std::remove_if(candidate_lines.begin(), candidate_lines.end(), [this](const LineId& edge) {
+        return line_state(edge).m_nb_alt >= m_solver_policy.m_max_nb_alternatives_probing_edge;
+    }), candidate_lines.end());
+    assert(is_sorted_by_nb_alternatives());
+    for (auto idx = 0u; idx < m_solver_policy.m_nb_of_lines_for_probing_round && idx < m_all_lines.size(); idx++)
+    {
+        const LineId& line_id = m_all_lines[idx];
+        if (!line_state(line_id).m_completed &&
+            line_state(line_id).m_nb_alt < m_solver_policy.m_max_nb_alternatives_probing_other)
+        {
+            candidate_lines.emplace_back(line_id);
+        }
+    }
+    if (use_parallel_probing() && start_thread_pool())
+    {
+        result = parallel_probe(candidate_lines);
+        if (result.m_status != Solver::Status::OK || result.m_grid_has_changed)
+            return result;
+    }
+    else
+    {
+        for (auto candidate : candidate_lines)
+        {
+            if (!line_state(candidate).m_probed)
+            {
+                result = probe(candidate);
+                switch (result.m_status)
+                {
+                case Solver::Status::OK:
+                    break;
+
+                case Solver::Status::ABORTED:
+                case Solver::Status::CONTRADICTORY_GRID:
+                    return result;
+
+                case Solver::Status::NOT_LINE_SOLVABLE:
+                default:
+                    assert(0);
+                    break;
+                }
+                if (result.m_grid_has_changed)
+                {
+                    result.m_continue_probing = true;
+                    m_probing_depth_incr = 1u;
+                    return result;
+                }
+            }
+        }
+    }
+    if (m_solver_policy.m_cell_probing)
+        result = probe_cells();
+    return result;
+}
+
+// This method probes a specific line. It returns true if the grid was changed, false otherwise
+template <typename SolverPolicy>
+typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe(LineId line_id)
+{
+    ProbingResult result{};
+    assert(line_state(line_id).m_fully_reduced);
+
+    const LineSpan known_tiles = get_line(line_id.m_type, line_id.m_index);
 
     // Probe lines only once per solve
-    assert(!m_line_probed[line_id.m_type][line_id.m_index]);
-    m_line_probed[line_id.m_type][line_id.m_index] = true;
+    assert(!line_state(line_id).m_probed);
+    record_line_in_trail(line_id.m_type, line_id.m_index);
+    line_state(line_id).m_probed = true;
 
     // Cache the full reduction of all the possible orthogonal lines
-    if constexpr (SolverPolicy::LINE_CACHE_ENABLED)
+    if (m_solver_policy.m_line_cache)
     {
         fill_cache_with_orthogonal_lines(line_id);
     }
 
-    // Build all alternatives for that row or column
-    const auto list_of_all_alternatives = line_constraint.build_all_possible_lines(known_tiles);
-    assert(!list_of_all_alternatives.empty());  // Then the grid would be contradictory, but this must be catched earlier
-    const auto nb_alt = static_cast<unsigned int>(list_of_all_alternatives.size());
+    // The alternatives for that row or column are enumerated one at a time
+    AlternativesEnumerator& alternatives = alternatives_enumerator(line_id);
+    const auto nb_alt = line_state(line_id).m_nb_alt;
     assert(nb_alt >= 2);
 
     if (m_observer)
@@ -875,7 +1516,7 @@ typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe(Lin
         const auto line_known_tiles = line_from_line_span(known_tiles);
         ObserverData data;
         data.m_depth = m_branching_depth;
-        data.m_misc_i = nb_alt;
+        data.m_misc_i = observer_nb_alternatives(nb_alt);
         m_observer(ObserverEvent::BRANCHING, &line_known_tiles, data);
     }
 
@@ -885,19 +1526,24 @@ typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe(Lin
         m_grid_stats->total_nb_probing_alternatives += nb_alt;
     }
 
-    std::optional<GridSnapshot<Line::ROW>> reduced_grid;
+    bool has_reduced_grid = false;
     Solver::SolutionFound do_nothing_with_found_solution = [](Solver::Solution&&) -> bool { return true; };
     auto nested_solver_policy = m_solver_policy;
     nested_solver_policy.m_branching_allowed = false;
     LineAlternatives::NbAlt progress = 0u;
     auto& probing_work_grid = nested_work_grid();
-    for (const Line& guess_line : list_of_all_alternatives)
+    while (alternatives.next())
     {
-        // Copy current grid state to a nested grid
+        const Line& guess_line = alternatives.current();
+        // Copy current grid state to a nested grid, or undo the changes made on the nested grid by the previous alternative
         const auto nested_progress = nested_progress_bar(m_progress_bar, progress, nb_alt);
-        std::unique_ptr<GridStats> nested_stats = m_grid_stats ? std::make_unique<GridStats>() : nullptr;
-        probing_work_grid = *this;
-        probing_work_grid.configure(nested_solver_policy, WorkGridState::LINEAR_REDUCTION, nested_stats.get(), nested_progress.first, nested_progress.second);
+        GridStats* nested_stats = m_grid_stats ? &m_nested_grid_stats : nullptr;
+        if (nested_stats) { reset_grid_stats(*nested_stats); }
+        if (progress == 0u || !probing_work_grid.m_trail.m_recording)
+            probing_work_grid = *this;
+        else
+            probing_work_grid.undo_changes(*this);
+        probing_work_grid.configure(nested_solver_policy, WorkGridState::LINEAR_REDUCTION, nested_stats, nested_progress.first, nested_progress.second);
         if (m_observer)
         {
             ObserverData data;
@@ -907,19 +1553,22 @@ typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe(Lin
 
         // Set one line in the new_grid according to the hypothesis we made. That line is then complete
         probing_work_grid.update_line(guess_line, 1u);
-        probing_work_grid.m_line_is_fully_reduced[guess_line.type()][guess_line.index()] = true;
-        assert(probing_work_grid.m_line_completed[guess_line.type()][guess_line.index()]);
+        probing_work_grid.line_state(guess_line.type(), guess_line.index()).m_fully_reduced = true;
+        assert(probing_work_grid.line_state(guess_line.type(), guess_line.index()).m_completed);
 
         // Set orthogonal lines retrived from cache
-        if constexpr (SolverPolicy::LINE_CACHE_ENABLED)
+        if (m_solver_policy.m_line_cache)
         {
             set_orthogonal_lines_from_cache(probing_work_grid, guess_line);
         }
+        const bool consistent_implications = probing_work_grid.apply_implications(*this, guess_line);
 
         probing_work_grid.partition_completed_lines();
 
         // Solve the new grid!
-        const auto status = probing_work_grid.line_solve(do_nothing_with_found_solution, true);
+        const auto status = consistent_implications
+            ? probing_work_grid.line_solve(do_nothing_with_found_solution, true)
+            : Solver::Status::CONTRADICTORY_GRID;
 
         if (m_grid_stats)
         {
@@ -935,14 +1584,17 @@ typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe(Lin
 
         if (status != Solver::Status::CONTRADICTORY_GRID)
         {
-            if (!reduced_grid)
-                reduced_grid.emplace(static_cast<Grid&>(probing_work_grid));
+            if (!has_reduced_grid)
+                m_probing_snapshot = static_cast<Grid&>(probing_work_grid);
             else
-                reduced_grid->reduce(static_cast<Grid&>(probing_work_grid));
+                m_probing_snapshot.reduce(static_cast<Grid&>(probing_work_grid));
+            has_reduced_grid = true;
         }
 
         progress++;
     }
+    assert(progress > 0u);      // Otherwise the grid would be contradictory, but this must be catched earlier
+    assert(progress == nb_alt);
 #ifndef NDEBUG
     m_branch_line_cache.clear();
 #endif
@@ -953,29 +1605,479 @@ typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe(Lin
         const auto line_known_tiles = line_from_line_span(known_tiles);
         ObserverData data;
         data.m_depth = m_branching_depth;
-        data.m_misc_i = nb_alt;
+        data.m_misc_i = observer_nb_alternatives(nb_alt);
         m_observer(ObserverEvent::BRANCHING, &line_known_tiles, data);
     }
 
-    if (!reduced_grid)
+    if (!has_reduced_grid)
     {
         result.m_status = Solver::Status::CONTRADICTORY_GRID;
         return result;
     }
 
+    result.m_grid_has_changed = update_rows(m_probing_snapshot);
+
+    return result;
+}
+
+// Cell probing round, once the line probing round did not change the grid. Since the probing of a line subsumes the
+// probing of its tiles, the tiles of the lines that were not probed are probed, starting with the lines with the fewest
+// alternatives. The round stops once the grid has changed.
+template <typename SolverPolicy>
+typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe_cells()
+{
+    assert(m_branching_depth == 0u);
+    ProbingResult result{};
+    if (m_probed_cells.empty())
+        m_probed_cells.resize(width() * height(), false);
+    unsigned int nb_probed_cells = 0u;
+    for (auto line_it = m_all_lines.begin(); line_it != m_uncompleted_lines_end; ++line_it)
+    {
+        const LineId line_id = *line_it;
+        if (line_state(line_id).m_probed)
+            continue;
+        const LineSpan known_tiles = get_line(line_id);
+        const Line::Type orth_type = line_id.m_type == Line::ROW ? Line::COL : Line::ROW;
+        for (Line::Index idx = 0u; idx < static_cast<Line::Index>(known_tiles.size()); idx++)
+        {
+            if (known_tiles[static_cast<int>(idx)] != Tile::UNKNOWN || line_state(orth_type, idx).m_probed)
+                continue;
+            const Line::Index x = line_id.m_type == Line::ROW ? idx : line_id.m_index;
+            const Line::Index y = line_id.m_type == Line::ROW ? line_id.m_index : idx;
+            if (m_probed_cells[y * width() + x])
+                continue;
+            if (nb_probed_cells++ == m_solver_policy.m_nb_of_cells_for_probing_round)
+                return result;
+            result = probe_cell(x, y);
+            if (result.m_status != Solver::Status::OK)
+                return result;
+            if (result.m_grid_has_changed)
+            {
+                result.m_continue_probing = true;
+                m_probing_depth_incr = 1u;
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+// Probe a tile: it is set to filled, then to empty, and each assumption is line solved. The tiles that have the same value
+// in both outcomes are kept. If one of the assumptions is contradictory, the tile is set to the other value. The tiles found
+// by each assumption are recorded as implications, which are reused by the later probes and branches.
+template <typename SolverPolicy>
+typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::probe_cell(Line::Index x, Line::Index y)
+{
+    ProbingResult result{};
+    assert(get(x, y) == Tile::UNKNOWN);
+    m_probed_cells[y * width() + x] = true;
+
+    const LineSpan known_tiles = get_line(Line::ROW, y);
+    const auto nb_alt = line_state(Line::ROW, y).m_nb_alt;
+    if (m_observer)
+    {
+        const auto line_known_tiles = line_from_line_span(known_tiles);
+        ObserverData data;
+        data.m_depth = m_branching_depth;
+        data.m_misc_i = 2u;
+        m_observer(ObserverEvent::BRANCHING, &line_known_tiles, data);
+    }
+
+    if (m_grid_stats != nullptr) { m_grid_stats->nb_cell_probing_calls++; }
+
+    bool has_reduced_grid = false;
+    Solver::SolutionFound do_nothing_with_found_solution = [](Solver::Solution&&) -> bool { return true; };
+    auto nested_solver_policy = m_solver_policy;
+    nested_solver_policy.m_branching_allowed = false;
+    LineAlternatives::NbAlt progress = 0u;
+    auto& probing_work_grid = nested_work_grid();
+    for (const Tile key : { Tile::FILLED, Tile::EMPTY })
+    {
+        const auto nested_progress = nested_progress_bar(m_progress_bar, progress, 2u);
+        GridStats* nested_stats = m_grid_stats ? &m_nested_grid_stats : nullptr;
+        if (nested_stats) { reset_grid_stats(*nested_stats); }
+        if (progress == 0u || !probing_work_grid.m_trail.m_recording)
+            probing_work_grid = *this;
+        else
+            probing_work_grid.undo_changes(*this);
+        probing_work_grid.configure(nested_solver_policy, WorkGridState::LINEAR_REDUCTION, nested_stats, nested_progress.first, nested_progress.second);
+        if (m_observer)
+        {
+            ObserverData data;
+            data.m_depth = probing_work_grid.m_branching_depth;
+            m_observer(ObserverEvent::BRANCHING, nullptr, data);
+        }
+
+        // Set the tile on its row, which then needs to be reduced as well as the column
+        Line& assumption = line_buffers(Line::ROW, y).m_known_tiles;
+        copy_line_span(assumption, known_tiles);
+        assumption[x] = key;
+        probing_work_grid.update_line(assumption, nb_alt);
+        probing_work_grid.schedule_line_reduction(Line::ROW, y);
+        const ImplicationGraph::Literal premise{ x, y, key };
+        const bool consistent_implications = probing_work_grid.apply_implications(premise);
+
+        probing_work_grid.partition_completed_lines();
+
+        // Solve the new grid!
+        const auto status = consistent_implications
+            ? probing_work_grid.line_solve(do_nothing_with_found_solution, true)
+            : Solver::Status::CONTRADICTORY_GRID;
+
+        if (m_grid_stats)
+        {
+            assert(nested_stats);
+            merge_branching_grid_stats(*m_grid_stats, *nested_stats);
+        }
+
+        if (status == Solver::Status::ABORTED)
+        {
+            result.m_status = status;
+            return result;
+        }
+
+        if (status != Solver::Status::CONTRADICTORY_GRID)
+        {
+            record_implications(premise, probing_work_grid);
+            if (!has_reduced_grid)
+                m_probing_snapshot = static_cast<Grid&>(probing_work_grid);
+            else
+                m_probing_snapshot.reduce(static_cast<Grid&>(probing_work_grid));
+            has_reduced_grid = true;
+        }
+
+        progress++;
+    }
+
+    // Repeat start branching message
+    if (m_observer)
+    {
+        const auto line_known_tiles = line_from_line_span(known_tiles);
+        ObserverData data;
+        data.m_depth = m_branching_depth;
+        data.m_misc_i = 2u;
+        m_observer(ObserverEvent::BRANCHING, &line_known_tiles, data);
+    }
+
+    if (!has_reduced_grid)
+    {
+        result.m_status = Solver::Status::CONTRADICTORY_GRID;
+        return result;
+    }
+
+    result.m_grid_has_changed = update_rows(m_probing_snapshot);
+
+    return result;
+}
+
+// The tiles found by an assumption made on this grid
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::record_implications(const ImplicationGraph::Literal& premise, const WorkGrid& nested_grid)
+{
+    assert(m_implications);
+    ImplicationGraph::Literals& conclusions = m_implication_buffer;
+    conclusions.clear();
+    for (Line::Index y = 0u; y < height(); y++)
+    {
+        const LineSpan known_tiles = get_line(Line::ROW, y);
+        const LineSpan nested_tiles = nested_grid.get_line(Line::ROW, y);
+        for (Line::Index x = 0u; x < width(); x++)
+        {
+            const Tile tile = nested_tiles[static_cast<int>(x)];
+            if (tile != Tile::UNKNOWN && known_tiles[static_cast<int>(x)] == Tile::UNKNOWN && (x != premise.m_x || y != premise.m_y))
+                conclusions.push_back(ImplicationGraph::Literal{ x, y, tile });
+        }
+    }
+    m_implications->add(premise, conclusions);
+    if (m_grid_stats != nullptr) { m_grid_stats->nb_implications = static_cast<unsigned int>(m_implications->nb_implications()); }
+}
+
+// Set the tiles implied by a literal of this grid. Return false if an implied tile contradicts a known one.
+// The implications are not used with an observer, since it is only notified of the line updates.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::apply_implications(const ImplicationGraph::Literal& premise)
+{
+    assert(m_implications);
+    if (m_observer)
+        return true;
+    unsigned int nb_implied_tiles = 0u;
+    const DecisionLevels decision_levels = line_state(Line::ROW, premise.m_y).m_decision_levels;
+    const bool consistent = m_implications->for_each_implied(premise, [this, &nb_implied_tiles, decision_levels](const ImplicationGraph::Literal& conclusion) {
+        const Tile tile = get(conclusion.m_x, conclusion.m_y);
+        if (tile == conclusion.m_tile)
+            return true;
+        if (tile != Tile::UNKNOWN)
+            return false;
+        update(conclusion.m_x, conclusion.m_y, conclusion.m_tile);
+        record_tile_in_trail(conclusion.m_x, conclusion.m_y);
+        line_has_updates(Line::ROW, conclusion.m_y);
+        line_has_updates(Line::COL, conclusion.m_x);
+        line_state(Line::ROW, conclusion.m_y).m_decision_levels |= decision_levels;
+        line_state(Line::COL, conclusion.m_x).m_decision_levels |= decision_levels;
+        nb_implied_tiles++;
+        return true;
+    });
+    if (m_grid_stats != nullptr) { m_grid_stats->nb_implied_tiles += nb_implied_tiles; }
+    return consistent;
+}
+
+// Same as above for the tiles of the line on which an hypothesis was made, that were unknown on the parent grid
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::apply_implications(const WorkGrid& parent, const LineSpan& guess_line)
+{
+    assert(m_implications);
+    if (m_implications->empty())
+        return true;
+    const LineSpan parent_tiles = parent.get_line(guess_line.type(), guess_line.index());
+    for (Line::Index idx = 0u; idx < static_cast<Line::Index>(guess_line.size()); idx++)
+    {
+        if (parent_tiles[static_cast<int>(idx)] != Tile::UNKNOWN)
+            continue;
+        const Line::Index x = guess_line.type() == Line::ROW ? idx : guess_line.index();
+        const Line::Index y = guess_line.type() == Line::ROW ? guess_line.index() : idx;
+        if (!apply_implications(ImplicationGraph::Literal{ x, y, guess_line[static_cast<int>(idx)] }))
+            return false;
+    }
+    return true;
+}
+
+// Update the rows with the tiles of a reduced grid, e.g. the intersection of the alternatives of a probed line. Return true
+// if the grid has changed.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::update_rows(const GridSnapshot<Line::ROW>& reduced_grid)
+{
+    bool grid_has_changed = false;
+    m_probing_row.resize(width());
     for (Line::Index row_idx = 0; row_idx < height(); row_idx++)
     {
-        const auto reduced_line = reduced_grid->get_line(row_idx);
-        const auto nb_alternatives = m_nb_alternatives[Line::ROW][row_idx];
+        if (line_state(Line::ROW, row_idx).m_completed)
+            continue;
+        const LineSpanW reduced_line(Line::ROW, row_idx, m_probing_row.size(), m_probing_row.data());
+        reduced_grid.copy_line_to(reduced_line);
+        const auto nb_alternatives = line_state(Line::ROW, row_idx).m_nb_alt;
         const bool line_changed = update_line(reduced_line, nb_alternatives);
-        result.m_grid_has_changed |= line_changed;
+        grid_has_changed |= line_changed;
         if (line_changed)
-            m_line_is_fully_reduced[Line::ROW][row_idx] = false;
+            schedule_line_reduction(Line::ROW, row_idx);
     }
+    return grid_has_changed;
+}
+
+// The probing rounds of the root grid are parallel, unless an observer is set
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::use_parallel_probing() const
+{
+    return m_solver_policy.m_parallel_probing && m_solver_policy.m_nb_threads != 1u && m_branching_depth == 0u
+        && m_parallel_search == nullptr && !m_observer;
+}
+
+// Parallel probing round. The threads solve the alternatives of the first candidate line, then of the next one, etc., each
+// alternative on the nested grid of a worker. As in probe(), the round stops once a probed line changed the grid. The other
+// lines of which all the alternatives were solved are applied as well, since this grid was not modified in the meantime.
+template <typename SolverPolicy>
+typename WorkGrid<SolverPolicy>::ProbingResult WorkGrid<SolverPolicy>::parallel_probe(const AllLines& candidate_lines)
+{
+    assert(use_parallel_probing());
+    assert(m_thread_pool && !m_thread_pool->is_running());
+    ProbingResult result{};
 
+    ProbingRound round{};
+    for (const LineId& line_id : candidate_lines)
+    {
+        LineState& state = line_state(line_id);
+        if (state.m_probed)
+            continue;
+        assert(state.m_fully_reduced);
+        assert(state.m_nb_alt >= 2);
+        record_line_in_trail(line_id.m_type, line_id.m_index);
+        state.m_probed = true;
+        round.m_candidates.push_back(ProbingCandidate{ line_id, &alternatives_enumerator(line_id), state.m_nb_alt, 0u, false, std::nullopt });
+    }
+    if (round.m_candidates.empty())
+        return result;
+    const Grid::Container& tiles = get_container(Line::ROW);
+    round.m_nb_known_tiles = static_cast<std::size_t>(std::count_if(tiles.begin(), tiles.end(), [](Tile tile) { return tile != Tile::UNKNOWN; }));
+    round.m_stop = false;
+
+    ParallelSearch search(m_abort_function);
+    search.m_worker_stats.resize(m_thread_pool->nb_threads());
+    auto worker = [this, &search, &round](std::size_t, unsigned int thread_idx) {
+        try
+        {
+            probe_alternatives(search, round, thread_idx);
+        }
+        catch (...)
+        {
+            search.m_stop.store(true, std::memory_order_relaxed);
+            throw;
+        }
+    };
+    m_thread_pool->parallel_for(m_thread_pool->nb_threads(), worker);
+
+    if (m_grid_stats != nullptr)
+    {
+        for (const GridStats& worker_stats : search.m_worker_stats)
+            merge_branching_grid_stats(*m_grid_stats, worker_stats);
+        for (const ProbingCandidate& candidate : round.m_candidates)
+        {
+            if (candidate.m_nb_solved == 0u)
+                continue;
+            m_grid_stats->nb_probing_calls++;
+            m_grid_stats->total_nb_probing_alternatives += candidate.m_nb_solved;
+        }
+    }
+
+    if (search.m_stop.load(std::memory_order_relaxed))
+    {
+        result.m_status = Solver::Status::ABORTED;
+        return result;
+    }
+
+    for (const ProbingCandidate& candidate : round.m_candidates)
+    {
+        if (candidate.m_nb_solved == candidate.m_nb_alt && !candidate.m_reduced_grid)
+        {
+            result.m_status = Solver::Status::CONTRADICTORY_GRID;
+            return result;
+        }
+    }
+
+    for (const ProbingCandidate& candidate : round.m_candidates)
+    {
+        // The lines that were not completely probed can be probed again in a later round
+        if (candidate.m_nb_solved < candidate.m_nb_alt)
+        {
+            line_state(candidate.m_line_id).m_probed = false;
+            continue;
+        }
+        result.m_grid_has_changed |= update_rows(*candidate.m_reduced_grid);
+    }
+    if (result.m_grid_has_changed)
+    {
+        result.m_continue_probing = true;
+        m_probing_depth_incr = 1u;
+    }
     return result;
 }
 
+// Loop of a worker of a parallel probing round. The root grid of the worker is a copy of this grid, that caches the
+// orthogonal lines of the line being probed by the worker. As in probe(), the alternatives are solved on its nested grid.
+// The worker reduces the alternatives it solved into the snapshot of its root grid, that is merged into the candidate line
+// when the worker moves on to another line.
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::probe_alternatives(ParallelSearch& search, ProbingRound& round, unsigned int thread_idx)
+{
+    WorkGrid& worker_grid = this->worker_grid(thread_idx);
+    GridStats* worker_stats = m_grid_stats ? &search.m_worker_stats[thread_idx] : nullptr;
+    GridStats* nested_stats = m_grid_stats ? &worker_grid.m_nested_grid_stats : nullptr;
+    worker_grid = *this;
+    worker_grid.m_branching_depth = m_branching_depth;
+    worker_grid.set_stats(nested_stats);
+    WorkGrid& probing_work_grid = worker_grid.nested_work_grid();
+    probing_work_grid.m_branching_depth = m_branching_depth + 1u;
+    probing_work_grid.m_parallel_search = &search;
+    auto nested_solver_policy = worker_grid.m_solver_policy;
+    nested_solver_policy.m_branching_allowed = false;
+    Solver::SolutionFound do_nothing_with_found_solution = [](Solver::Solution&&) -> bool { return true; };
+    bool is_copy = false;
+
+    ProbingCandidate* candidate = nullptr;         // The line the worker is probing
+    LineAlternatives::NbAlt nb_solved = 0u;
+    GridSnapshot<Line::ROW>& reduced_grid = worker_grid.m_probing_snapshot;
+    bool has_reduced_grid = false;
+    const auto merge_into_candidate = [&round, &candidate, &nb_solved, &reduced_grid, &has_reduced_grid]() {
+        if (candidate == nullptr)
+            return;
+        if (has_reduced_grid)
+        {
+            if (!candidate->m_reduced_grid)
+                candidate->m_reduced_grid = reduced_grid;
+            else
+                candidate->m_reduced_grid->reduce(reduced_grid);
+        }
+        candidate->m_nb_solved += nb_solved;
+        if (candidate->m_nb_solved == candidate->m_nb_alt)
+            round.m_stop |= !candidate->m_reduced_grid || candidate->m_reduced_grid->nb_known_tiles() > round.m_nb_known_tiles;
+        candidate = nullptr;
+        nb_solved = 0u;
+        has_reduced_grid = false;
+    };
+
+    std::unique_lock<std::mutex> lock(search.m_mutex);
+    auto candidate_it = round.m_candidates.begin();
+    while (!round.m_stop && !search.m_stop.load(std::memory_order_relaxed))
+    {
+        candidate_it = std::find_if(candidate_it, round.m_candidates.end(), [](const ProbingCandidate& c) { return !c.m_exhausted; });
+        if (candidate_it == round.m_candidates.end())
+            break;
+        if (!candidate_it->m_alternatives->next())
+        {
+            candidate_it->m_exhausted = true;
+            continue;
+        }
+        const bool new_candidate = candidate != &*candidate_it;
+        if (new_candidate)
+        {
+            merge_into_candidate();
+            candidate = &*candidate_it;
+        }
+        const LineId line_id = candidate->m_line_id;
+        Line& guess_line = worker_grid.line_buffers(line_id.m_type, line_id.m_index).m_known_tiles;
+        copy_line_span(guess_line, LineSpan(candidate->m_alternatives->current()));
+        lock.unlock();
+
+        if (nested_stats) { reset_grid_stats(*nested_stats); }
+        if (m_solver_policy.m_line_cache)
+        {
+            if (new_candidate)
+                worker_grid.fill_cache_with_orthogonal_lines(line_id);
+        }
+        if (!is_copy || !probing_work_grid.m_trail.m_recording)
+            probing_work_grid = worker_grid;
+        else
+            probing_work_grid.undo_changes(worker_grid);
+        is_copy = true;
+        probing_work_grid.configure(nested_solver_policy, WorkGridState::LINEAR_REDUCTION, nested_stats, m_progress_bar.first, m_progress_bar.second);
+        probing_work_grid.update_line(guess_line, 1u);
+        probing_work_grid.line_state(line_id).m_fully_reduced = true;
+        assert(probing_work_grid.line_state(line_id).m_completed);
+        if (m_solver_policy.m_line_cache)
+        {
+            worker_grid.set_orthogonal_lines_from_cache(probing_work_grid, guess_line);
+        }
+        const bool consistent_implications = probing_work_grid.apply_implications(worker_grid, guess_line);
+        probing_work_grid.partition_completed_lines();
+
+        // Solve the new grid!
+        const auto status = consistent_implications
+            ? probing_work_grid.line_solve(do_nothing_with_found_solution, true)
+            : Solver::Status::CONTRADICTORY_GRID;
+
+        if (worker_stats)
+        {
+            assert(nested_stats);
+            merge_branching_grid_stats(*worker_stats, *nested_stats);
+        }
+        if (status == Solver::Status::ABORTED)
+        {
+            search.m_stop.store(true, std::memory_order_relaxed);
+            lock.lock();
+            break;
+        }
+        if (status != Solver::Status::CONTRADICTORY_GRID)
+        {
+            if (!has_reduced_grid)
+                reduced_grid = static_cast<Grid&>(probing_work_grid);
+            else
+                reduced_grid.reduce(static_cast<Grid&>(probing_work_grid));
+            has_reduced_grid = true;
+        }
+        nb_solved++;
+        lock.lock();
+    }
+    merge_into_candidate();
+}
+
 // This method will test a range of alternatives for one particular line of the grid, each time
 // creating a new instance of the grid class on which the function WorkGrid<SolverPolicy>::solve() is called.
 template <typename SolverPolicy>
@@ -985,28 +2087,25 @@ Solver::Status WorkGrid<SolverPolicy>::branch(const Solver::SolutionFound& solut
     assert(m_all_lines.begin() != m_uncompleted_lines_end);
 
     const LineId search_line = next_line_for_search();
-    assert(m_line_is_fully_reduced[search_line.m_type][search_line.m_index]);
-    const LineConstraint& line_constraint = m_constraints[search_line.m_type][search_line.m_index];
+    assert(line_state(search_line).m_fully_reduced);
     const LineSpan known_tiles = get_line(search_line.m_type, search_line.m_index);
-    const auto nb_alt = m_nb_alternatives[search_line.m_type][search_line.m_index];
+    const auto nb_alt = line_state(search_line).m_nb_alt;
     assert(nb_alt >= 2);
 
     // Cache the full reduction of all the possible orthogonal lines
-    if constexpr (SolverPolicy::LINE_CACHE_ENABLED)
+    if (m_solver_policy.m_line_cache)
     {
         fill_cache_with_orthogonal_lines(search_line);
     }
 
-    // Build all alternatives for that row or column
-    const auto list_of_all_alternatives = line_constraint.build_all_possible_lines(known_tiles);
-    assert(list_of_all_alternatives.size() == nb_alt);
-    assert(!list_of_all_alternatives.empty());  // Then the grid would be contradictory, but this must be catched earlier
+    // The alternatives for that row or column are enumerated one at a time
+    AlternativesEnumerator& alternatives = alternatives_enumerator(search_line);
 
     if (m_observer)
     {
         ObserverData data;
         data.m_depth = m_branching_depth;
-        data.m_misc_i = nb_alt;
+        data.m_misc_i = observer_nb_alternatives(nb_alt);
         const auto line_known_tiles = line_from_line_span(known_tiles);
         m_observer(ObserverEvent::BRANCHING, &line_known_tiles, data);
     }
@@ -1021,47 +2120,18 @@ Solver::Status WorkGrid<SolverPolicy>::branch(const Solver::SolutionFound& solut
         max_nb_alt = std::max(max_nb_alt, nb_alt);
     }
 
-    auto nested_solver_policy = m_solver_policy;
+    // In the parallel search, the other workers can steal the alternatives of that line until the branching is done
+    BranchNode node(m_parallel_search, this, &alternatives, search_line);
 
     Solver::Status status = Solver::Status::OK;
     bool flag_solution_found = false;
+    bool backjump = false;
+    DecisionLevels conflict_levels = 0u;
     LineAlternatives::NbAlt progress = 0u;
     auto& branching_work_grid = nested_work_grid();
-    for (const Line& guess_line : list_of_all_alternatives)
+    while (const Line* guess_line = next_alternative(node))
     {
-        // Copy current grid state to a nested grid
-        const auto nested_progress = nested_progress_bar(m_progress_bar, progress, nb_alt);
-        std::unique_ptr<GridStats> nested_stats = m_grid_stats ? std::make_unique<GridStats>() : nullptr;
-        branching_work_grid = *this;
-        branching_work_grid.configure(nested_solver_policy, WorkGridState::LINEAR_REDUCTION, nested_stats.get(), nested_progress.first, nested_progress.second);
-        if (m_observer)
-        {
-            ObserverData data;
-            data.m_depth = branching_work_grid.m_branching_depth;
-            m_observer(ObserverEvent::BRANCHING, nullptr, data);
-        }
-
-        // Set one line in the new_grid according to the hypothesis we made. That line is then complete
-        branching_work_grid.update_line(guess_line, 1u);
-        branching_work_grid.m_line_is_fully_reduced[guess_line.type()][guess_line.index()] = true;
-        assert(branching_work_grid.m_line_completed[guess_line.type()][guess_line.index()]);
-
-        // Set orthogonal lines retrived from cache
-        if constexpr (SolverPolicy::LINE_CACHE_ENABLED)
-        {
-            set_orthogonal_lines_from_cache(branching_work_grid, guess_line);
-        }
-
-        branching_work_grid.partition_completed_lines();
-
-        // Solve the new grid!
-        status = branching_work_grid.solve(solution_found);
-
-        if (m_grid_stats)
-        {
-            assert(nested_stats);
-            merge_branching_grid_stats(*m_grid_stats, *nested_stats);
-        }
+        status = solve_alternative(branching_work_grid, *guess_line, progress, nb_alt, m_solver_policy.m_line_cache, solution_found);
 
         flag_solution_found |= (status == Solver::Status::OK);
 
@@ -1077,22 +2147,419 @@ Solver::Status WorkGrid<SolverPolicy>::branch(const Solver::SolutionFound& solut
 
         if (status == Solver::Status::ABORTED)
             return status;
+
+        if (status == Solver::Status::CONTRADICTORY_GRID && use_backjumping() && analyze_conflict(branching_work_grid, conflict_levels))
+        {
+            assert(!flag_solution_found);
+            backjump = true;
+            break;
+        }
     }
+    if (m_parallel_search != nullptr && m_parallel_search->m_stop.load(std::memory_order_relaxed))
+        return Solver::Status::ABORTED;
 #ifndef NDEBUG
     m_branch_line_cache.clear();
 #endif
 
+    // The contradiction found with the last alternative does not depend on the hypothesis made on this line, therefore
+    // this grid is contradictory. The remaining alternatives are skipped.
+    if (backjump)
+    {
+        LineAlternatives::NbAlt nb_stolen = node.m_nb_stolen;
+        if (node.m_search != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(node.m_search->m_mutex);
+            node.m_exhausted = true;
+            nb_stolen = node.m_nb_stolen;
+        }
+        if (m_grid_stats != nullptr)
+        {
+            m_grid_stats->nb_backjumps++;
+            m_grid_stats->nb_backjump_skipped_alternatives += static_cast<unsigned int>(nb_alt - progress - nb_stolen);
+        }
+        return Solver::Status::CONTRADICTORY_GRID;
+    }
+    assert(progress > 0u || node.m_nb_stolen > 0u);     // Otherwise the grid would be contradictory, but this must be catched earlier
+    assert(progress + node.m_nb_stolen == nb_alt);
+    m_conflict_levels = use_backjumping() ? conflict_levels : decision_levels_up_to(m_branching_depth);
+
     // Repeat start branching message
     if (m_observer)
     {
         ObserverData data;
         data.m_depth = m_branching_depth;
-        data.m_misc_i = nb_alt;
+        data.m_misc_i = observer_nb_alternatives(nb_alt);
         const auto line_known_tiles = line_from_line_span(known_tiles);
         m_observer(ObserverEvent::BRANCHING, &line_known_tiles, data);
     }
 
-    return flag_solution_found ? Solver::Status::OK : Solver::Status::CONTRADICTORY_GRID;
+    // The outcome of the stolen alternatives is not known here, therefore the grid is then not reported as contradictory.
+    return (flag_solution_found || node.m_nb_stolen > 0u) ? Solver::Status::OK : Solver::Status::CONTRADICTORY_GRID;
+}
+
+
+// In the parallel search, the enumerator of the branch node is also advanced by the workers that steal its alternatives,
+// therefore the alternative is copied while the search is locked. The copy is made in the buffer of the branching line,
+// which is not used by the nested grids since the line is complete in those.
+template <typename SolverPolicy>
+const Line* WorkGrid<SolverPolicy>::next_alternative(BranchNode& node)
+{
+    if (node.m_search == nullptr)
+        return node.m_alternatives->next() ? &node.m_alternatives->current() : nullptr;
+
+    std::lock_guard<std::mutex> lock(node.m_search->m_mutex);
+    if (node.m_exhausted || node.m_search->m_stop.load(std::memory_order_relaxed) || !node.m_alternatives->next())
+    {
+        node.m_exhausted = true;
+        return nullptr;
+    }
+    Line& guess_line = line_buffers(node.m_line_id.m_type, node.m_line_id.m_index).m_known_tiles;
+    copy_line_span(guess_line, LineSpan(node.m_alternatives->current()));
+    return &guess_line;
+}
+
+
+// The backjumping and the nogoods are disabled with an observer, since the events it receives describe a complete
+// depth-first search.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::use_backjumping() const
+{
+    return m_solver_policy.m_backjumping && !m_observer;
+}
+
+
+// Analysis of the contradiction of the nested grid, which depends on some of the hypotheses made on the way to it. If it
+// does not depend on the last one, this grid is contradictory as well and the method returns true. Otherwise the other
+// hypotheses are added to conflict_levels, the contradiction of this grid if all of its alternatives are contradictory.
+// The lines set by those hypotheses are stored as a nogood, unless that is the whole series of hypotheses, which the
+// depth-first search does not make twice.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::analyze_conflict(const WorkGrid& nested_grid, DecisionLevels& conflict_levels)
+{
+    const unsigned int nested_depth = nested_grid.m_branching_depth;
+    const DecisionLevels nested_conflict_levels = nested_grid.m_conflict_levels;
+    const DecisionLevels all_decision_levels = decision_levels_up_to(nested_depth) & ~decision_level_bit(0u);
+    if ((nested_conflict_levels & all_decision_levels) != all_decision_levels)
+    {
+        m_nogood_buffer.clear();
+        for (const auto type : { Line::ROW, Line::COL })
+        {
+            const auto nb_lines = static_cast<Line::Index>(type == Line::ROW ? height() : width());
+            for (Line::Index index = 0u; index < nb_lines; index++)
+            {
+                const unsigned int depth = nested_grid.line_state(type, index).m_decision_depth;
+                if (depth > 0u && (nested_conflict_levels & decision_level_bit(depth)) != 0u)
+                    m_nogood_buffer.push_back(NogoodStore::Decision{ LineId(type, index), NogoodStore::line_hash(nested_grid.get_line(type, index)) });
+            }
+        }
+        if (m_nogoods->add(m_nogood_buffer) && m_grid_stats != nullptr)
+            m_grid_stats->nb_nogoods++;
+    }
+
+    const DecisionLevels own_level = decision_level_bit(nested_depth);
+    if ((nested_conflict_levels & own_level) == 0u)
+    {
+        m_conflict_levels = nested_conflict_levels;
+        return true;
+    }
+    conflict_levels |= nested_depth < 63u ? nested_conflict_levels & ~own_level : nested_conflict_levels;
+    return false;
+}
+
+
+// Look for a nogood involving the line on which the hypothesis was made, all the lines of which are set in this grid
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::is_known_nogood(const LineSpan& guess_line)
+{
+    if (!use_backjumping())
+        return false;
+    const LineId guess_line_id(guess_line.type(), guess_line.index());
+    const bool hit = m_nogoods->find(guess_line_id, NogoodStore::line_hash(guess_line), [this, &guess_line_id](const NogoodStore::Decision* begin, const NogoodStore::Decision* end) {
+        DecisionLevels conflict_levels = 0u;
+        for (const NogoodStore::Decision* decision = begin; decision != end; ++decision)
+        {
+            const LineState& state = line_state(decision->m_line_id);
+            const bool same_line = decision->m_line_id.m_type == guess_line_id.m_type && decision->m_line_id.m_index == guess_line_id.m_index;
+            if (!state.m_completed || (!same_line && NogoodStore::line_hash(get_line(decision->m_line_id)) != decision->m_hash))
+                return false;
+            conflict_levels |= state.m_decision_levels;
+        }
+        m_conflict_levels = conflict_levels;
+        return true;
+    });
+    if (hit && m_grid_stats != nullptr) { m_grid_stats->nb_nogood_hits++; }
+    return hit;
+}
+
+
+// Solve the nested grid obtained by setting one line of this grid to one of its alternatives
+template <typename SolverPolicy>
+Solver::Status WorkGrid<SolverPolicy>::solve_alternative(WorkGrid& nested_grid, const LineSpan& guess_line, LineAlternatives::NbAlt progress, LineAlternatives::NbAlt nb_alt, bool orthogonal_lines_cached, const Solver::SolutionFound& solution_found)
+{
+    // Copy current grid state to a nested grid, or undo the changes made on the nested grid by the previous alternative
+    const auto nested_progress = nested_progress_bar(m_progress_bar, progress, nb_alt);
+    GridStats* nested_stats = m_grid_stats ? &m_nested_grid_stats : nullptr;
+    if (nested_stats) { reset_grid_stats(*nested_stats); }
+    if (progress == 0u || !nested_grid.m_trail.m_recording)
+        nested_grid = *this;
+    else
+        nested_grid.undo_changes(*this);
+    nested_grid.configure(m_solver_policy, WorkGridState::LINEAR_REDUCTION, nested_stats, nested_progress.first, nested_progress.second);
+    nested_grid.m_parallel_search = m_parallel_search;
+    nested_grid.m_conflict_levels = decision_levels_up_to(nested_grid.m_branching_depth);
+    if (m_observer)
+    {
+        ObserverData data;
+        data.m_depth = nested_grid.m_branching_depth;
+        m_observer(ObserverEvent::BRANCHING, nullptr, data);
+    }
+
+    // Set one line in the new_grid according to the hypothesis we made. That line is then complete
+    LineState& guess_line_state = nested_grid.line_state(guess_line.type(), guess_line.index());
+    guess_line_state.m_decision_levels |= decision_level_bit(nested_grid.m_branching_depth);
+    guess_line_state.m_decision_depth = nested_grid.m_branching_depth;
+    nested_grid.update_line(guess_line, 1u);
+    guess_line_state.m_fully_reduced = true;
+    assert(guess_line_state.m_completed);
+
+    // Set orthogonal lines retrived from cache
+    if (orthogonal_lines_cached)
+        set_orthogonal_lines_from_cache(nested_grid, guess_line);
+    const bool consistent_implications = nested_grid.apply_implications(*this, guess_line);
+
+    nested_grid.partition_completed_lines();
+
+    // Solve the new grid, unless the hypothesis is a known nogood
+    Solver::Status status = Solver::Status::CONTRADICTORY_GRID;
+    if (consistent_implications && !nested_grid.is_known_nogood(guess_line))
+    {
+        status = nested_grid.solve(solution_found);
+    }
+
+    if (m_grid_stats)
+    {
+        assert(nested_stats);
+        merge_branching_grid_stats(*m_grid_stats, *nested_stats);
+    }
+
+    return status;
+}
+
+
+template <typename SolverPolicy>
+WorkGrid<SolverPolicy>::BranchNode::BranchNode(ParallelSearch* search, const WorkGrid* grid, AlternativesEnumerator* alternatives, LineId line_id)
+    : m_search(search)
+    , m_grid(grid)
+    , m_alternatives(alternatives)
+    , m_line_id(line_id)
+    , m_exhausted(false)
+    , m_nb_stolen(0u)
+{
+    if (m_search == nullptr)
+        return;
+    std::lock_guard<std::mutex> lock(m_search->m_mutex);
+    m_search->m_nodes.push_back(this);
+    if (m_search->m_nb_idle_workers > 0u)
+        m_search->m_condition.notify_all();
+}
+
+
+template <typename SolverPolicy>
+WorkGrid<SolverPolicy>::BranchNode::~BranchNode()
+{
+    if (m_search == nullptr)
+        return;
+    std::lock_guard<std::mutex> lock(m_search->m_mutex);
+    auto& nodes = m_search->m_nodes;
+    const auto it = std::find(nodes.rbegin(), nodes.rend(), this);
+    assert(it != nodes.rend());
+    nodes.erase(std::next(it).base());
+}
+
+
+// Start the threads of the parallel branch search and probing, if they were not started for the grid passes.
+// Return false if the solver has a single thread.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::start_thread_pool()
+{
+    assert(m_branching_depth == 0u);
+    if (!m_thread_pool)
+        m_thread_pool = std::make_shared<ThreadPool>(m_solver_policy.m_nb_threads);
+    const unsigned int nb_threads = m_thread_pool->nb_threads();
+    m_worker_grids.resize(nb_threads);
+    return nb_threads > 1u;
+}
+
+
+// The root grid of a worker thread. A worker does not run its grid passes in parallel.
+template <typename SolverPolicy>
+WorkGrid<SolverPolicy>& WorkGrid<SolverPolicy>::worker_grid(unsigned int thread_idx)
+{
+    assert(thread_idx < m_worker_grids.size());
+    auto& worker_grid_ptr = m_worker_grids[thread_idx];
+    if (!worker_grid_ptr)
+    {
+        auto worker_policy = m_solver_policy;
+        worker_policy.m_nb_threads = 1u;
+        worker_grid_ptr = std::unique_ptr<WorkGrid<SolverPolicy>>(new WorkGrid<SolverPolicy>(m_model, name(), worker_policy, Observer(), Solver::Abort(), 0.f, 1.f));
+        // The implications are only added by the root grid, while the workers are idle
+        worker_grid_ptr->m_implications = m_implications;
+    }
+    return *worker_grid_ptr;
+}
+
+
+// The parallel search is started from the root grid. It is disabled with an observer, since the events it receives
+// describe a single depth-first search.
+template <typename SolverPolicy>
+bool WorkGrid<SolverPolicy>::use_parallel_branching() const
+{
+    return m_solver_policy.m_parallel_branching && m_solver_policy.m_nb_threads != 1u && m_branching_depth == 0u
+        && m_parallel_search == nullptr && !m_observer;
+}
+
+
+// Parallel branch search. One worker searches from this grid, as branch() does, while the others steal the untried
+// alternatives of the branch nodes of all the workers, starting with the shallowest nodes. A worker solves a stolen
+// alternative on its own stack of nested grids, the root of which is a copy of the branching grid of the node.
+// The found solutions are passed to the callback one at a time.
+template <typename SolverPolicy>
+Solver::Status WorkGrid<SolverPolicy>::parallel_branch(const Solver::SolutionFound& solution_found)
+{
+    assert(use_parallel_branching());
+    assert(m_thread_pool && !m_thread_pool->is_running());
+    const unsigned int nb_threads = m_thread_pool->nb_threads();
+    ParallelSearch search(m_abort_function);
+    search.m_worker_stats.resize(nb_threads);
+    const Solver::SolutionFound funnel = [&search, &solution_found](Solver::Solution&& solution) -> bool {
+        std::lock_guard<std::mutex> lock(search.m_solution_mutex);
+        if (search.m_stop.load(std::memory_order_relaxed))
+            return false;
+        search.m_nb_solutions++;
+        const bool cont = solution_found(std::move(solution));
+        if (!cont)
+            search.m_stop.store(true, std::memory_order_relaxed);
+        return cont;
+    };
+
+    m_parallel_search = &search;
+    auto worker = [this, &funnel](std::size_t idx, unsigned int thread_idx) {
+        if (idx == 0u)
+        {
+            Solver::Status status = Solver::Status::OK;
+            try
+            {
+                status = branch(funnel);
+            }
+            catch (...)
+            {
+                end_parallel_search_worker(true);
+                throw;
+            }
+            end_parallel_search_worker(status == Solver::Status::ABORTED);
+        }
+        steal_alternatives(thread_idx, funnel);
+    };
+    try
+    {
+        m_thread_pool->parallel_for(nb_threads, worker);
+    }
+    catch (...)
+    {
+        m_parallel_search = nullptr;
+        throw;
+    }
+    m_parallel_search = nullptr;
+
+    if (m_grid_stats != nullptr)
+    {
+        for (const GridStats& worker_stats : search.m_worker_stats)
+            merge_branching_grid_stats(*m_grid_stats, worker_stats);
+    }
+
+    if (search.m_stop.load(std::memory_order_relaxed))
+        return Solver::Status::ABORTED;
+    return search.m_nb_solutions > 0u ? Solver::Status::OK : Solver::Status::CONTRADICTORY_GRID;
+}
+
+
+// Loop of a worker of the parallel search that has no branch node of its own. It returns once all the workers are idle,
+// or if the search is stopped.
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::steal_alternatives(unsigned int thread_idx, const Solver::SolutionFound& solution_found)
+{
+    assert(m_parallel_search);
+    ParallelSearch& search = *m_parallel_search;
+    WorkGrid& worker_grid = this->worker_grid(thread_idx);
+    worker_grid.m_parallel_search = &search;
+    worker_grid.set_stats(m_grid_stats ? &search.m_worker_stats[thread_idx] : nullptr);
+
+    std::unique_lock<std::mutex> lock(search.m_mutex);
+    while (!search.m_stop.load(std::memory_order_relaxed))
+    {
+        const auto node_it = std::min_element(search.m_nodes.begin(), search.m_nodes.end(), [](const BranchNode* lhs, const BranchNode* rhs) {
+            if (lhs->m_exhausted != rhs->m_exhausted)
+                return rhs->m_exhausted;
+            return lhs->m_grid->m_branching_depth < rhs->m_grid->m_branching_depth;
+        });
+        if (node_it == search.m_nodes.end() || (*node_it)->m_exhausted)
+        {
+            if (search.m_nb_active_workers == 0u)
+                break;
+            search.m_nb_idle_workers++;
+            search.m_condition.wait(lock);
+            search.m_nb_idle_workers--;
+            continue;
+        }
+        BranchNode& node = **node_it;
+        if (!node.m_alternatives->next())
+        {
+            node.m_exhausted = true;
+            continue;
+        }
+
+        // The branching grid of the node is copied while the search is locked, since the node is then still registered
+        const WorkGrid& node_grid = *node.m_grid;
+        worker_grid = node_grid;
+        worker_grid.m_branching_depth = node_grid.m_branching_depth;
+        for (WorkGrid* grid = &worker_grid; grid->m_nested_work_grid; grid = grid->m_nested_work_grid.get())
+            grid->m_nested_work_grid->m_branching_depth = grid->m_branching_depth + 1u;
+        Line& guess_line = worker_grid.line_buffers(node.m_line_id.m_type, node.m_line_id.m_index).m_known_tiles;
+        copy_line_span(guess_line, LineSpan(node.m_alternatives->current()));
+        node.m_nb_stolen++;
+        search.m_nb_active_workers++;
+        lock.unlock();
+
+        if (worker_grid.m_grid_stats != nullptr) { worker_grid.m_grid_stats->nb_stolen_branching_alternatives++; }
+        Solver::Status status = Solver::Status::OK;
+        try
+        {
+            status = worker_grid.solve_alternative(worker_grid.nested_work_grid(), guess_line, 0u, 1u, false, solution_found);
+        }
+        catch (...)
+        {
+            end_parallel_search_worker(true);
+            throw;
+        }
+        end_parallel_search_worker(status == Solver::Status::ABORTED);
+        lock.lock();
+    }
+    search.m_condition.notify_all();
+}
+
+
+template <typename SolverPolicy>
+void WorkGrid<SolverPolicy>::end_parallel_search_worker(bool stop)
+{
+    assert(m_parallel_search);
+    ParallelSearch& search = *m_parallel_search;
+    std::lock_guard<std::mutex> lock(search.m_mutex);
+    assert(search.m_nb_active_workers > 0u);
+    search.m_nb_active_workers--;
+    if (stop)
+        search.m_stop.store(true, std::memory_order_relaxed);
+    if (search.m_nb_active_workers == 0u || stop)
+        search.m_condition.notify_all();
 }
 
 
@@ -1101,8 +2568,8 @@ bool WorkGrid<SolverPolicy>::is_valid_solution() const
 {
     assert(is_completed());
     bool valid = true;
-    for (unsigned int x = 0u; x < width(); x++)  { valid &= m_constraints[Line::COL][x].compatible(get_line(Line::COL, x)); }
-    for (unsigned int y = 0u; y < height(); y++) { valid &= m_constraints[Line::ROW][y].compatible(get_line(Line::ROW, y)); }
+    for (unsigned int x = 0u; x < width(); x++)  { valid &= m_model->constraint(Line::COL, x).compatible(get_line(Line::COL, x)); }
+    for (unsigned int y = 0u; y < height(); y++) { valid &= m_model->constraint(Line::ROW, y).compatible(get_line(Line::ROW, y)); }
     return valid;
 }
 
@@ -1127,7 +2594,7 @@ bool WorkGrid<SolverPolicy>::found_solution(const Solver::SolutionFound& solutio
 template <typename SolverPolicy>
 void WorkGrid<SolverPolicy>::fill_cache_with_orthogonal_lines(LineId line_id)
 {
-    assert(SolverPolicy::LINE_CACHE_ENABLED);
+    assert(m_solver_policy.m_line_cache);
     const LineSpan known_tiles = get_line(line_id);
     const Line::Type orth_type = line_id.m_type == Line::ROW ? Line::COL : Line::ROW;
     std::size_t orth_idx = 0u;
@@ -1136,14 +2603,24 @@ void WorkGrid<SolverPolicy>::fill_cache_with_orthogonal_lines(LineId line_id)
         if (tile == Tile::UNKNOWN)
         {
             const LineId orth_line_id(orth_type, orth_idx);
-            const LineConstraint& constraint = m_constraints[orth_type][orth_idx];
-            Line orth_line = line_from_line_span(get_line(orth_line_id));
+            LineBuffers& buffers = line_buffers(orth_type, orth_line_id.m_index);
+            Line& orth_line = buffers.m_known_tiles;
+            copy_line_span(orth_line, get_line(orth_line_id));
             assert(orth_line[line_id.m_index] == Tile::UNKNOWN);
             for (Tile key : { Tile::EMPTY, Tile::FILLED })
             {
                 orth_line[line_id.m_index] = key;
                 assert(m_full_reduction_buffers);
-                const auto reduction = LineAlternatives(constraint, orth_line, *m_binomial).full_reduction(m_full_reduction_buffers.get());
+                LineAlternatives::Reduction& reduction = buffers.m_reduction;
+                full_reduction_with_cache(reduction, orth_line, [this, &buffers, &orth_line, orth_line_id](LineAlternatives::Reduction& result) {
+                    if (use_line_automaton(orth_line_id.m_type, orth_line_id.m_index))
+                        return m_model->automaton(orth_line_id.m_type, orth_line_id.m_index).full_reduction(result, orth_line, *m_automaton_buffers);
+                    if (buffers.m_alternatives)
+                        buffers.m_alternatives->reset();
+                    else
+                        buffers.m_alternatives.emplace(m_model->constraint(orth_line_id.m_type, orth_line_id.m_index), orth_line, *m_binomial);
+                    return buffers.m_alternatives->full_reduction(result, m_full_reduction_buffers.get());
+                });
                 m_branch_line_cache.store_line(orth_line_id, key, reduction.reduced_line, reduction.nb_alternatives);
                 if (m_grid_stats != nullptr)
                 {
@@ -1160,7 +2637,7 @@ void WorkGrid<SolverPolicy>::fill_cache_with_orthogonal_lines(LineId line_id)
 template <typename SolverPolicy>
 void WorkGrid<SolverPolicy>::set_orthogonal_lines_from_cache(WorkGrid& target_grid, const LineSpan& alternative) const
 {
-    assert(SolverPolicy::LINE_CACHE_ENABLED);
+    assert(m_solver_policy.m_line_cache);
     const LineId line_id(alternative.type(), alternative.index());
     const LineSpan known_tiles = get_line(line_id);
     const Line::Type orth_type = line_id.m_type == Line::ROW ? Line::COL : Line::ROW;
@@ -1179,8 +2656,11 @@ void WorkGrid<SolverPolicy>::set_orthogonal_lines_from_cache(WorkGrid& target_gr
             // to be in the situation where nb_alt = 0 (which would mean the tile on the orthogonal line could be found by a line solve).
             // If that still happens in Release, the line is not set as fully reduced therefore the contradicton will be detected later on.
             assert(orth_line_entry.m_nb_alt != 0);
-            assert(orth_line_entry.m_nb_alt != 1 || target_grid.m_line_completed[orth_type][orth_idx]);
-            target_grid.m_line_is_fully_reduced[orth_type][orth_idx] = (orth_line_entry.m_nb_alt > 0);
+            assert(orth_line_entry.m_nb_alt != 1 || target_grid.line_state(orth_line_id).m_completed);
+            if (orth_line_entry.m_nb_alt > 0)
+                target_grid.line_state(orth_line_id).m_fully_reduced = true;
+            else
+                target_grid.schedule_line_reduction(orth_type, static_cast<Line::Index>(orth_idx));
         }
         orth_idx++;
     }
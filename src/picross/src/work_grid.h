@@ -7,19 +7,35 @@
  ******************************************************************************/
 #pragma once
 
+#include "arena.h"
 #include "binomial.h"
 #include "grid.h"
+#include "implication_graph.h"
 #include "line.h"
+#include "line_activity.h"
 #include "line_alternatives.h"
+#include "line_automaton.h"
 #include "line_cache.h"
 #include "line_constraint.h"
+#include "nogood_store.h"
+#include "puzzle_model.h"
+#include "reduction_cache.h"
+#include "thread_pool.h"
 
 #include <picross/picross.h>
 
 #include <stdutils/macros.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <ostream>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace picross {
@@ -62,7 +78,134 @@ private:
             return *this;
         }
     };
+    // Bitset of the branching depths of the hypotheses on which some tiles depend. The depths from 63 onward share the last bit.
+    using DecisionLevels = std::uint64_t;
+    // State of a line of the grid
+    struct LineState
+    {
+        LineAlternatives::NbAlt m_nb_alt = 0u;
+        unsigned int            m_rank = 0u;                // Position of the uncompleted line in m_all_lines
+        bool                    m_completed = false;
+        bool                    m_has_updates = false;
+        bool                    m_fully_reduced = false;
+        bool                    m_probed = false;
+        bool                    m_nb_alt_changed = false;   // Since the last sort of m_all_lines
+        bool                    m_to_reduce = false;        // The line is in m_lines_to_reduce or in m_pass_worklist
+        DecisionLevels          m_decision_levels = 0u;     // Hypotheses on which the known tiles of the line depend
+        unsigned int            m_decision_depth = 0u;      // Branching depth of the hypothesis made on the line. Zero if none
+
+        bool operator==(const LineState& other) const
+        {
+            return m_nb_alt == other.m_nb_alt && m_rank == other.m_rank && m_completed == other.m_completed
+                && m_has_updates == other.m_has_updates && m_fully_reduced == other.m_fully_reduced && m_probed == other.m_probed
+                && m_nb_alt_changed == other.m_nb_alt_changed && m_to_reduce == other.m_to_reduce
+                && m_decision_levels == other.m_decision_levels && m_decision_depth == other.m_decision_depth;
+        }
+    };
     using AllLines = std::vector<LineId>;
+    using WorklistWord = std::uint64_t;
+    static constexpr std::size_t WORKLIST_WORD_BITS = 64u;
+    // Changes made on a nested grid since it was copied from its parent, in order to undo them in place
+    struct Trail
+    {
+        bool                                                m_enabled = false;
+        bool                                                m_recording = false;    // False if too many tiles were set, then the parent is copied again
+        std::size_t                                         m_max_nb_tiles = 0u;
+        std::vector<std::pair<Line::Index, Line::Index>>    m_tiles;                // (x, y) of the tiles set by the nested grid
+        std::vector<LineId>                                 m_lines;                // Lines of which the alternatives were modified
+        std::vector<bool>                                   m_line_in_trail[2];
+    };
+    // Preallocated lines, such that a line is reduced without allocating
+    struct LineBuffers
+    {
+        LineAlternatives::Reduction                         m_reduction;
+        Line                                                m_known_tiles;          // A copy of the known tiles, that can be modified
+        std::optional<LineAlternatives>                     m_alternatives;         // Of m_known_tiles, built on first use
+        std::optional<AlternativesEnumerator>               m_enumerator;           // Built on first use
+    };
+    // Buffers of one thread of the parallel grid passes
+    struct ThreadBuffers
+    {
+        ThreadBuffers(unsigned int max_nb_segments, unsigned int max_line_length)
+            : m_full_reduction(max_nb_segments, max_line_length)
+            , m_automaton()
+            , m_arena()
+        {}
+
+        FullReductionBuffers                                m_full_reduction;
+        LineAutomaton::Buffers                              m_automaton;
+        Arena                                               m_arena;
+    };
+    // Shared by the nested grids, which do not run their grid passes concurrently
+    struct ParallelPass
+    {
+        std::vector<std::unique_ptr<ThreadBuffers>>         m_thread_buffers;       // One per thread of the pool
+        AllLines                                            m_lines;                // Lines reduced concurrently
+        std::vector<char>                                   m_cache_hits;           // Of the full reductions of m_lines
+    };
+    struct ParallelSearch;
+    // A branching grid of the parallel search, of which the untried alternatives can be stolen by the idle workers.
+    // The node is registered in the search for the duration of the branching.
+    struct BranchNode
+    {
+        BranchNode(ParallelSearch* search, const WorkGrid* grid, AlternativesEnumerator* alternatives, LineId line_id);
+        ~BranchNode();
+        BranchNode(const BranchNode&) = delete;
+        BranchNode& operator=(const BranchNode&) = delete;
+
+        ParallelSearch*                                     m_search;               // Null if the search is sequential
+        const WorkGrid*                                     m_grid;                 // Not modified while the node is registered
+        AlternativesEnumerator*                             m_alternatives;
+        LineId                                              m_line_id;
+        bool                                                m_exhausted;
+        unsigned int                                        m_nb_stolen;            // Alternatives solved by the other workers
+    };
+    // Shared by the workers of the parallel branch search, or of a parallel probing round. Each worker owns a stack of nested grids.
+    struct ParallelSearch
+    {
+        explicit ParallelSearch(Solver::Abort abort_function)
+            : m_mutex()
+            , m_condition()
+            , m_nodes()
+            , m_nb_active_workers(1u)
+            , m_nb_idle_workers(0u)
+            , m_stop(false)
+            , m_abort_function(std::move(abort_function))
+            , m_abort_mutex()
+            , m_solution_mutex()
+            , m_nb_solutions(0u)
+            , m_worker_stats()
+        {}
+
+        std::mutex                                          m_mutex;                // Guards the nodes, their enumerators and the worker counts
+        std::condition_variable                             m_condition;
+        std::vector<BranchNode*>                            m_nodes;
+        unsigned int                                        m_nb_active_workers;    // Starts with the worker that branches on the root grid
+        unsigned int                                        m_nb_idle_workers;
+        std::atomic<bool>                                   m_stop;                 // Aborted, or enough solutions were found
+        Solver::Abort                                       m_abort_function;
+        std::mutex                                          m_abort_mutex;          // Serializes the calls to the abort function
+        std::mutex                                          m_solution_mutex;       // Serializes the calls to the SolutionFound callback
+        std::size_t                                         m_nb_solutions;
+        std::vector<GridStats>                              m_worker_stats;         // One per thread
+    };
+    // A line probed by a parallel probing round. Its alternatives are enumerated while the search is locked.
+    struct ProbingCandidate
+    {
+        LineId                                              m_line_id;
+        AlternativesEnumerator*                             m_alternatives;
+        LineAlternatives::NbAlt                             m_nb_alt;
+        LineAlternatives::NbAlt                             m_nb_solved;
+        bool                                                m_exhausted;
+        std::optional<GridSnapshot<Line::ROW>>              m_reduced_grid;         // Intersection of the non contradictory alternatives
+    };
+    // Guarded by the mutex of the search
+    struct ProbingRound
+    {
+        std::vector<ProbingCandidate>                       m_candidates;
+        std::size_t                                         m_nb_known_tiles;       // Of the probed grid
+        bool                                                m_stop;                 // A probed line changed the grid, or was contradictory
+    };
 private:
     struct ProbingResult
     {
@@ -76,32 +219,85 @@ public:
     WorkGrid(WorkGrid&&) noexcept = delete;
     WorkGrid& operator=(WorkGrid&&) noexcept = delete;
 private:
+    WorkGrid(std::shared_ptr<const PuzzleModel> model, std::string_view name, const SolverPolicy& solver_policy, Observer observer, Solver::Abort abort_function, float min_progress, float max_progress);
     WorkGrid(const WorkGrid& parent);                 // Allocate a nested search grid, in a reset state
     WorkGrid& operator=(const WorkGrid& parent);      // Copy the grid data, some of the main data structures, and reset others
+    void undo_changes(const WorkGrid& parent);        // Same result as operator=, provided the parent was not modified since then
 public:
     void set_stats(GridStats* stats);
     Solver::Status line_solve(const Solver::SolutionFound& solution_found);
     Solver::Status solve(const Solver::SolutionFound& solution_found);
 private:
+    LineAlternatives& line_alternatives(Line::Type type, Line::Index index);
     WorkGrid<SolverPolicy>& nested_work_grid();
     void configure(const SolverPolicy& solver_policy, WorkGridState initial_state, GridStats* stats, float min_progress, float max_progress);
     Solver::Status line_solve(const Solver::SolutionFound& solution_found, bool currently_probing);
     bool all_lines_completed() const;
-    bool update_line(const LineSpan& line, unsigned int nb_alt);
+    bool update_line(const LineSpan& line, LineAlternatives::NbAlt nb_alt);
+    void record_line_in_trail(Line::Type type, Line::Index index);
+    void record_tile_in_trail(Line::Index x, Line::Index y);
+    bool is_same_state(const WorkGrid& other) const;
+    void copy_line_states_from(const WorkGrid& parent);
+    LineState& line_state(Line::Type type, Line::Index index) { return m_line_states[line_state_index(type, index)]; }
+    const LineState& line_state(Line::Type type, Line::Index index) const { return m_line_states[line_state_index(type, index)]; }
+    LineState& line_state(const LineId& line_id) { return line_state(line_id.m_type, line_id.m_index); }
+    const LineState& line_state(const LineId& line_id) const { return line_state(line_id.m_type, line_id.m_index); }
+    std::size_t line_state_index(Line::Type type, Line::Index index) const { return type == Line::ROW ? index : height() + index; }
+    LineBuffers& line_buffers(Line::Type type, Line::Index index) { return (*m_line_buffers)[line_state_index(type, index)]; }
+    AlternativesEnumerator& alternatives_enumerator(LineId line_id);
+    void line_has_updates(Line::Type type, Line::Index index);
+    void schedule_line_reduction(Line::Type type, Line::Index index);
     void partition_completed_lines();
-    std::vector<LineId> sorted_edges() const;
-    std::vector<LineId> sorted_lines_next_to_completed() const;
+    void update_line_ranks();
+    void sorted_edges(AllLines& lines) const;
+    void sorted_lines_next_to_completed(AllLines& lines) const;
     void sort_by_nb_alternatives();
     bool is_sorted_by_nb_alternatives() const;
-    LineId next_line_for_search() const;
+    LineId next_line_for_search();
     PassStatus single_line_initial_pass(Line::Type type, unsigned int index);
     PassStatus single_line_linear_reduction(Line::Type type, unsigned int index);
     PassStatus single_line_full_reduction(Line::Type type, unsigned int index);
+    void linear_reduction(Line::Type type, unsigned int index, Arena& arena);
+    PassStatus apply_linear_reduction(Line::Type type, unsigned int index);
+    bool full_reduction(Line::Type type, unsigned int index, FullReductionBuffers& buffers, LineAutomaton::Buffers* automaton_buffers);
+    PassStatus apply_full_reduction(Line::Type type, unsigned int index, bool cache_hit);
+    bool use_line_automaton(Line::Type type, unsigned int index) const;
+    bool read_reduction_cache(LineAlternatives::Reduction& result, const LineSpan& known_tiles) const;
+    void store_reduction_cache(const LineSpan& known_tiles, const LineAlternatives::Reduction& reduction);
+    template <typename Reduce>
+    void full_reduction_with_cache(LineAlternatives::Reduction& result, const LineSpan& known_tiles, Reduce reduce);
+    template <WorkGridState S>
+    PassStatus single_line_pass(LineId line_id);
+    void end_single_line_pass(LineId line_id, const PassStatus& status);
+    void bump_conflict_lines(LineId contradictory_line_id);
+    bool is_aborted() const;
     template <WorkGridState S>
     PassStatus full_grid_pass();
+    template <WorkGridState S>
+    PassStatus parallel_grid_pass();
     ProbingResult probe();
     ProbingResult probe(LineId line_id);
+    ProbingResult probe_cells();
+    ProbingResult probe_cell(Line::Index x, Line::Index y);
+    void record_implications(const ImplicationGraph::Literal& premise, const WorkGrid& nested_grid);
+    bool apply_implications(const ImplicationGraph::Literal& premise);
+    bool apply_implications(const WorkGrid& parent, const LineSpan& guess_line);
+    bool use_parallel_probing() const;
+    bool update_rows(const GridSnapshot<Line::ROW>& reduced_grid);
+    ProbingResult parallel_probe(const AllLines& candidate_lines);
+    void probe_alternatives(ParallelSearch& search, ProbingRound& round, unsigned int thread_idx);
     Solver::Status branch(const Solver::SolutionFound& solution_found);
+    const Line* next_alternative(BranchNode& node);
+    bool use_backjumping() const;
+    bool analyze_conflict(const WorkGrid& nested_grid, DecisionLevels& conflict_levels);
+    bool is_known_nogood(const LineSpan& guess_line);
+    Solver::Status solve_alternative(WorkGrid& nested_grid, const LineSpan& guess_line, LineAlternatives::NbAlt progress, LineAlternatives::NbAlt nb_alt, bool orthogonal_lines_cached, const Solver::SolutionFound& solution_found);
+    bool start_thread_pool();
+    WorkGrid& worker_grid(unsigned int thread_idx);
+    bool use_parallel_branching() const;
+    Solver::Status parallel_branch(const Solver::SolutionFound& solution_found);
+    void steal_alternatives(unsigned int thread_idx, const Solver::SolutionFound& solution_found);
+    void end_parallel_search_worker(bool stop);
     bool is_valid_solution() const;
     bool found_solution(const Solver::SolutionFound& solution_found) const;
     void fill_cache_with_orthogonal_lines(LineId line_id);
@@ -109,28 +305,48 @@ private:
 private:
     WorkGridState                                   m_state;
     SolverPolicy                                    m_solver_policy;
-    unsigned int                                    m_max_k;             // Maximum nb of segments on a line constraint
-    std::vector<LineConstraint>                     m_constraints[2];
-    std::vector<LineAlternatives>                   m_alternatives[2];
-    std::vector<bool>                               m_line_completed[2];
-    std::vector<bool>                               m_line_has_updates[2];
-    std::vector<bool>                               m_line_is_fully_reduced[2];
-    std::vector<bool>                               m_line_probed[2];
-    std::vector<unsigned int>                       m_nb_alternatives[2];
+    std::shared_ptr<const PuzzleModel>              m_model;             // Line constraints and automata, shared by the nested grids
+    std::vector<std::optional<LineAlternatives>>    m_alternatives[2];   // Built on first use
+    std::vector<LineState>                          m_line_states;              // The rows, then the columns
     LineRange                                       m_uncompleted_lines_range[2];
     AllLines                                        m_all_lines;
     AllLines::iterator                              m_uncompleted_lines_end;
+    AllLines                                        m_lines_to_reduce;          // Lines not fully reduced (lazily cleaned of the completed or reduced ones)
+    std::vector<WorklistWord>                       m_pass_worklist;            // Bitset of the ranks of the lines to reduce in the current pass
+    AllLines                                        m_lines_buffer;
+    AllLines                                        m_probing_candidates;
+    std::vector<bool>                               m_probed_cells;             // Of the cell probing, on the root grid. Built on first use
+    ImplicationGraph::Literals                      m_implication_buffer;
+    GridSnapshot<Line::ROW>                         m_probing_snapshot;  // Intersection of the non contradictory alternatives of a probe. Reused by the probes
+    Line::Container                                 m_probing_row;       // Buffer of update_rows()
+    bool                                            m_pass_in_progress;
+    unsigned int                                    m_pass_rank;                // Rank of the line being reduced in the current pass
     GridStats*                                      m_grid_stats;        // If not null, the solver will store some stats in that structure
     Observer                                        m_observer;          // If not empty, the solver will notify the observer of its progress
     Solver::Abort                                   m_abort_function;    // If not empty, the solver will regularly call this function and abort if it returns true
-    unsigned int                                    m_max_nb_alternatives;
+    LineAlternatives::NbAlt                         m_max_nb_alternatives;
     unsigned int                                    m_branching_depth;
     unsigned int                                    m_probing_depth_incr;
     std::pair<float, float>                         m_progress_bar;
     std::unique_ptr<WorkGrid<SolverPolicy>>         m_nested_work_grid;
+    GridStats                                       m_nested_grid_stats; // Stats of the nested grid, merged into m_grid_stats after each alternative
+    Trail                                           m_trail;
     LineCache                                       m_branch_line_cache;
     std::shared_ptr<FullReductionBuffers>           m_full_reduction_buffers;
+    std::shared_ptr<LineAutomaton::Buffers>         m_automaton_buffers;
+    std::shared_ptr<ReductionCache>                 m_reduction_cache;
+    std::shared_ptr<ImplicationGraph>               m_implications;      // Found by the cell probing of the root grid
+    std::shared_ptr<NogoodStore>                    m_nogoods;           // Learned by the branch search
+    NogoodStore::Decisions                          m_nogood_buffer;
+    DecisionLevels                                  m_conflict_levels;   // Hypotheses on which the contradiction of the grid depends
+    std::shared_ptr<LineActivity>                   m_line_activity;     // Of the branching heuristic ACTIVITY, otherwise null
     std::shared_ptr<binomial::Cache>                m_binomial;
+    std::shared_ptr<Arena>                          m_arena;             // Shared by the nested work grids, released at the end of the solve
+    std::shared_ptr<std::vector<LineBuffers>>       m_line_buffers;      // The rows, then the columns
+    std::shared_ptr<ThreadPool>                     m_thread_pool;       // Null if the solver is sequential
+    std::shared_ptr<ParallelPass>                   m_parallel_pass;     // Null if the grid passes are sequential
+    ParallelSearch*                                 m_parallel_search;   // Set by the parent grid. Null if the branch search is sequential
+    std::vector<std::unique_ptr<WorkGrid>>          m_worker_grids;      // Root grids of the worker threads, built on first use by the root grid
 };
 
 } // namespace picross
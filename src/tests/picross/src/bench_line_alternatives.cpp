@@ -9,6 +9,9 @@
 #include "line_constraint.h"
 #include "line_span.h"
 
+#include <string>
+#include <utility>
+
 namespace picross {
 namespace {
     binomial::Cache& get_binomial()
@@ -146,6 +149,58 @@ TEST_CASE("Bench full reduction", "[line_alternatives]")
     }
 }
 
+TEST_CASE("Bench N_100 segment placement checks", "[line_alternatives]")
+{
+    // The linear reduction and the recursive full reduction both check segment placements against the known tiles.
+    // Those checks are O(1) range queries on the prefix counts of the known tiles (previously, a rescan of the tiles).
+    const auto known_tiles = build_line_from("??????????????????????????????????????????????????????????????????????????#?????????????????????????", Line::ROW, 0);
+    for (const auto& [constraint, nb_alt] : { std::make_pair(LineConstraint(Line::ROW, { 3 }), 3u), std::make_pair(LineConstraint(Line::ROW, { 3, 3 }), 273u) })
+    {
+        const std::string suffix = "N_100_K_" + std::to_string(constraint.nb_segments());
+        {
+            LineAlternatives::Reduction reduction;
+            bool bench_run = false;
+            BENCHMARK(suffix + " linear") {
+                reduction = linear_reduction(constraint, known_tiles);
+                bench_run = true;
+                return reduction;
+            };
+            if (bench_run)
+            {
+                CHECK(reduction.nb_alternatives >= nb_alt);
+            }
+        }
+        {
+            LineAlternatives::Reduction reduction;
+            bool bench_run = false;
+            BENCHMARK(suffix + " full recursive") {
+                reduction = LineAlternatives(constraint, known_tiles, get_binomial()).full_reduction_recursive();
+                bench_run = true;
+                return reduction;
+            };
+            if (bench_run)
+            {
+                CHECK(reduction.nb_alternatives == nb_alt);
+                CHECK(reduction.is_fully_reduced);
+            }
+        }
+        {
+            LineAlternatives::Reduction reduction;
+            bool bench_run = false;
+            BENCHMARK(suffix + " full") {
+                reduction = full_reduction(constraint, known_tiles);
+                bench_run = true;
+                return reduction;
+            };
+            if (bench_run)
+            {
+                CHECK(reduction.nb_alternatives == nb_alt);
+                CHECK(reduction.is_fully_reduced);
+            }
+        }
+    }
+}
+
 TEST_CASE("Bench linear vs full reduction", "[line_alternatives]")
 {
     const LineConstraint constraint(Line::ROW, { 3, 3, 3 });
@@ -0,0 +1,140 @@
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+#include <utils/text_io.h>
+
+#include "line.h"
+#include "line_alternatives.h"
+#include "line_automaton.h"
+#include "line_constraint.h"
+#include "line_span.h"
+
+namespace picross {
+
+// Same use cases as in bench_line_alternatives.cpp
+TEST_CASE("Bench line automaton", "[line_automaton]")
+{
+    LineAutomaton::Buffers buffers;
+
+    // A trivial example with a lone line and 1 segment
+    {
+        const LineConstraint constraint(Line::ROW, { 3 });
+        const auto known_tiles    = build_line_from("??????????????????????????????????????????????????????????????????????????#?????????????????????????", Line::ROW, 0);
+        const auto expected       = build_line_from("........................................................................??#??.......................", Line::ROW, 0);
+        const LineAutomaton automaton(constraint);
+        LineAlternatives::Reduction reduction;
+        bool bench_run = false;
+        BENCHMARK("N_100_K_1") {
+            reduction = automaton.full_reduction(known_tiles, buffers);
+            bench_run = true;
+            return reduction;
+        };
+        if (bench_run)
+        {
+            CHECK(reduction.reduced_line == expected);
+            CHECK(reduction.nb_alternatives == 3);
+            CHECK(reduction.is_fully_reduced);
+        }
+    }
+    // A trivial example with a lone line and 2 segments
+    {
+        const LineConstraint constraint(Line::ROW, { 3, 3 });
+        const auto known_tiles    = build_line_from("??????????????????????????????????????????????????????????????????????????#?????????????????????????", Line::ROW, 0);
+        const auto expected       = build_line_from("??????????????????????????????????????????????????????????????????????????#?????????????????????????", Line::ROW, 0);
+        const LineAutomaton automaton(constraint);
+        LineAlternatives::Reduction reduction;
+        bool bench_run = false;
+        BENCHMARK("N_100_K_2") {
+            reduction = automaton.full_reduction(known_tiles, buffers);
+            bench_run = true;
+            return  true;
+        };
+        if (bench_run)
+        {
+            CHECK(reduction.reduced_line == expected);
+            CHECK(reduction.nb_alternatives == 273);
+            CHECK(reduction.is_fully_reduced);
+        }
+    }
+    // Example from webpbn-03528-only-one.non
+    {
+        const LineConstraint constraint(Line::COL, { 3, 2, 4, 3, 1, 1, 2, 17, 2 });
+        const auto known_tiles    = build_line_from("..????????????????????#?????????????????????????????????????", Line::COL, 17);
+        const auto expected_delta = build_line_from("????????????????????????????????????????##??????????????????", Line::COL, 17);
+        const LineAutomaton automaton(constraint);
+        LineAlternatives::Reduction reduction;
+        bool bench_run = false;
+        BENCHMARK("COL 17") {
+            reduction = automaton.full_reduction(known_tiles, buffers);
+            bench_run = true;
+            return reduction;
+        };
+        if (bench_run)
+        {
+            CHECK((reduction.reduced_line - known_tiles) == expected_delta);
+            CHECK(reduction.nb_alternatives == 618206);
+            CHECK(reduction.is_fully_reduced);
+        }
+    }
+    // Example from tiger.non
+    {
+        const LineConstraint constraint(Line::ROW, { 2, 2, 2, 2, 3, 4, 2, 2, 3 });
+        const auto known_tiles    = build_line_from("???????????...???????.?????????????.?..?.?????????????????#??????????????..", Line::ROW, 45);
+        const auto expected_delta = build_line_from("????????????????????????????????????.??.???????????????????????????????????", Line::ROW, 45);
+        const LineAutomaton automaton(constraint);
+        LineAlternatives::Reduction reduction;
+        bool bench_run = false;
+        BENCHMARK("ROW 45") {
+            reduction = automaton.full_reduction(known_tiles, buffers);
+            bench_run = true;
+            return reduction;
+        };
+        if (bench_run)
+        {
+            CHECK((reduction.reduced_line - known_tiles) == expected_delta);
+            CHECK(reduction.nb_alternatives == 88714484);
+            CHECK(reduction.is_fully_reduced);
+        }
+    }
+    // Example from tiger.non
+    {
+        const LineConstraint constraint(Line::ROW, { 1, 2, 2, 1, 12, 1, 2, 2 });
+        const auto known_tiles    = build_line_from("???????????...???????..???????????###??###???????????????????????????????..", Line::ROW, 46);
+        const auto expected_delta = build_line_from("?????????????????????????????????????##????????????????????????????????????", Line::ROW, 46);
+        const LineAutomaton automaton(constraint);
+        LineAlternatives::Reduction reduction;
+        bool bench_run = false;
+        BENCHMARK("ROW 46") {
+            reduction = automaton.full_reduction(known_tiles, buffers);
+            bench_run = true;
+            return reduction;
+        };
+        if (bench_run)
+        {
+            CHECK((reduction.reduced_line - known_tiles) == expected_delta);
+            CHECK(reduction.nb_alternatives == 49441874);
+            CHECK(reduction.is_fully_reduced);
+        }
+    }
+    // Example from tiger.non
+    {
+        const LineConstraint constraint(Line::ROW, { 2, 2, 3, 3, 2, 3, 2, 2 });
+        const auto known_tiles    = build_line_from("???????????...???????...???????????#....##???????????????????????????????..", Line::ROW, 48);
+        const auto expected_delta = build_line_from("??????????????????????????????????#????????????????????????????????????????", Line::ROW, 48);
+        const LineAutomaton automaton(constraint);
+        LineAlternatives::Reduction reduction;
+        bool bench_run = false;
+        BENCHMARK("ROW 48") {
+            reduction = automaton.full_reduction(known_tiles, buffers);
+            bench_run = true;
+            return reduction;
+        };
+        if (bench_run)
+        {
+            CHECK((reduction.reduced_line - known_tiles) == expected_delta);
+            CHECK(reduction.nb_alternatives == 3873724);
+            CHECK(reduction.is_fully_reduced);
+        }
+    }
+}
+
+} // namespace picross
@@ -0,0 +1,195 @@
+/*
+ * Allocation count of the solver
+ *
+ *   This test is built in its own executable because it replaces the global operator new. Once the temporary buffers of
+ *   the solver are allocated, the line reductions, the probing and the branching do not use the heap, so the number of
+ *   allocations of a solve only depends on the size of the puzzle. The budgets below catch a regression in that respect.
+ *   The sequential solver is measured, then its probing, then a parallel solver: each of its workers allocates its own
+ *   root grid and stack of nested grids, which is bounded by a budget per worker.
+ */
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+#include <utils/text_io.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+
+namespace {
+    std::atomic<bool> g_count_allocations = false;
+    std::atomic<std::size_t> g_nb_allocations = 0u;
+
+    void* counted_malloc(std::size_t size)
+    {
+        if (g_count_allocations.load(std::memory_order_relaxed))
+            g_nb_allocations.fetch_add(1u, std::memory_order_relaxed);
+        if (size == 0u)
+            size = 1u;
+        void* ptr = std::malloc(size);
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+
+    void* counted_aligned_alloc(std::size_t size, std::align_val_t alignment)
+    {
+        if (g_count_allocations.load(std::memory_order_relaxed))
+            g_nb_allocations.fetch_add(1u, std::memory_order_relaxed);
+        const auto align = static_cast<std::size_t>(alignment);
+        // std::aligned_alloc requires a size multiple of the alignment
+        const std::size_t rounded_size = size == 0u ? align : (size + align - 1u) / align * align;
+        void* ptr = std::aligned_alloc(align, rounded_size);
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+} // namespace
+
+void* operator new(std::size_t size) { return counted_malloc(size); }
+void* operator new[](std::size_t size) { return counted_malloc(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return counted_aligned_alloc(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return counted_aligned_alloc(size, alignment); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+
+namespace picross {
+
+namespace {
+    // The N-DOM puzzles: a staircase of N dominoes whose solution requires a deep branching
+    OutputGrid build_domino_grid(unsigned int n)
+    {
+        const unsigned int size = 2u * n + 1u;
+        std::vector<std::string> rows(size, std::string(size, '.'));
+        for (unsigned int k = 0u; k < n; k++)
+        {
+            const unsigned int corner = size - 1u - 2u * k;
+            rows[2u * k].replace(corner - 2u, 3u, "###");
+            rows[2u * k + 1u][corner] = '#';
+            rows[2u * k + 2u][corner] = '#';
+        }
+        std::string tiles;
+        for (const auto& row : rows)
+            tiles += row + '\n';
+        return build_output_grid_from(size, size, tiles, std::to_string(n) + "-DOM");
+    }
+
+    struct SolveAllocations
+    {
+        Solver::Result result;
+        std::size_t nb_allocations;
+    };
+
+    SolveAllocations solve_and_count_allocations(const Solver& solver, const InputGrid& puzzle)
+    {
+        g_nb_allocations = 0u;
+        g_count_allocations = true;
+        Solver::Result result = solver.solve(puzzle);
+        g_count_allocations = false;
+        return SolveAllocations{ std::move(result), g_nb_allocations.load() };
+    }
+} // namespace
+
+TEST_CASE("The number of allocations of a solve does not depend on the search", "[allocations]")
+{
+    SolverConfig config;
+    config.nb_threads = 1u;
+    const auto solver = get_ref_solver(config);
+    REQUIRE(solver);
+    GridStats stats;
+    solver->set_stats(stats);
+
+    // The number of branching calls is multiplied by ten from one puzzle to the next, while the number of allocations
+    // follows the size of the grid. The budgets are about 25% above the actual counts.
+    struct Puzzle { unsigned int n; std::size_t budget; };
+    const Puzzle puzzles[] = { { 4u, 600u }, { 5u, 1400u }, { 6u, 1900u }, { 7u, 2600u } };
+    for (const auto& [n, budget] : puzzles)
+    {
+        const OutputGrid expected = build_domino_grid(n);
+        const InputGrid puzzle = get_input_grid_from(expected);
+
+        const auto [result, nb_allocations] = solve_and_count_allocations(*solver, puzzle);
+        INFO(expected.name() << ": " << nb_allocations << " allocations, " << stats.nb_branching_calls << " branching calls");
+
+        CHECK(result.status == Solver::Status::OK);
+        REQUIRE(result.solutions.size() == 1);
+        CHECK(result.solutions.front().grid == expected);
+        CHECK(nb_allocations <= budget);
+    }
+}
+
+TEST_CASE("The number of allocations of the probing does not depend on the number of probed alternatives", "[allocations]")
+{
+    // All the lines are probed in each round. The probing solve is compared to the same solve without probing: the nested
+    // grid, the snapshot of the probed grid and the row buffer are allocated once, whatever the number of alternatives.
+    // The budget is about 25% above the largest difference measured.
+    const std::size_t probing_budget = 125u;
+    for (unsigned int n = 5u; n <= 8u; n++)
+    {
+        const OutputGrid expected = build_domino_grid(n);
+        const InputGrid puzzle = get_input_grid_from(expected);
+
+        SolverConfig config;
+        config.nb_threads = 1u;
+        config.cell_probing = false;
+        config.nb_lines_per_probing_round = 1000u;
+        config.probing = false;
+        const auto [no_probing_result, no_probing_nb_allocations] = solve_and_count_allocations(*get_ref_solver(config), puzzle);
+
+        config.probing = true;
+        const auto solver = get_ref_solver(config);
+        REQUIRE(solver);
+        GridStats stats;
+        solver->set_stats(stats);
+        const auto [result, nb_allocations] = solve_and_count_allocations(*solver, puzzle);
+        INFO(expected.name() << ": " << nb_allocations << " allocations with probing, " << no_probing_nb_allocations << " without, " << stats.total_nb_probing_alternatives << " probed alternatives");
+
+        CHECK(no_probing_result.status == Solver::Status::OK);
+        CHECK(result.status == Solver::Status::OK);
+        REQUIRE(result.solutions.size() == 1);
+        CHECK(result.solutions.front().grid == expected);
+        CHECK(stats.total_nb_probing_alternatives > 0u);
+        CHECK(nb_allocations <= no_probing_nb_allocations + probing_budget);
+    }
+}
+
+TEST_CASE("The number of allocations of a parallel solve is bounded by worker", "[allocations]")
+{
+    SolverConfig config;
+    config.nb_threads = 4u;
+    const auto solver = get_ref_solver(config);
+    REQUIRE(solver);
+    GridStats stats;
+    solver->set_stats(stats);
+
+    // The budget of the sequential solve, plus a budget for each of the other threads. The latter depends on the size of
+    // the grid but not on the number of stolen alternatives, and is about 25% above the largest count measured.
+    struct Puzzle { unsigned int n; std::size_t budget; std::size_t worker_budget; };
+    const Puzzle puzzles[] = { { 5u, 1400u, 400u }, { 6u, 1900u, 900u }, { 7u, 2600u, 2100u } };
+    for (const auto& [n, budget, worker_budget] : puzzles)
+    {
+        const OutputGrid expected = build_domino_grid(n);
+        const InputGrid puzzle = get_input_grid_from(expected);
+
+        const auto [result, nb_allocations] = solve_and_count_allocations(*solver, puzzle);
+        INFO(expected.name() << ": " << nb_allocations << " allocations with " << config.nb_threads << " threads, " << stats.nb_stolen_branching_alternatives << " stolen alternatives");
+
+        CHECK(result.status == Solver::Status::OK);
+        REQUIRE(result.solutions.size() == 1);
+        CHECK(result.solutions.front().grid == expected);
+        CHECK(nb_allocations <= budget + (config.nb_threads - 1u) * worker_budget);
+    }
+}
+
+} // namespace picross
@@ -0,0 +1,68 @@
+#include <catch_amalgamated.hpp>
+
+#include "arena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+
+namespace picross {
+
+TEST_CASE("arena_allocation", "[arena]")
+{
+    Arena arena(256u);
+    CHECK(arena.nb_blocks() == 0u);
+
+    void* a = arena.allocate(10u, 1u);
+    void* b = arena.allocate(16u, 16u);
+    CHECK(arena.nb_blocks() == 1u);
+    CHECK(a != b);
+    CHECK(reinterpret_cast<std::uintptr_t>(b) % 16u == 0u);
+
+    // A request larger than the blocks gets its own block
+    void* c = arena.allocate(1000u, 8u);
+    CHECK(arena.nb_blocks() == 2u);
+    CHECK(arena.capacity() >= 1256u);
+    CHECK(reinterpret_cast<std::uintptr_t>(c) % 8u == 0u);
+
+    arena.release();
+    CHECK(arena.nb_blocks() == 0u);
+    CHECK(arena.capacity() == 0u);
+}
+
+TEST_CASE("arena_scope", "[arena]")
+{
+    Arena arena(256u);
+    void* first = nullptr;
+    {
+        Arena::Scope scope(arena);
+        first = arena.allocate(64u, 8u);
+        {
+            Arena::Scope nested_scope(arena);
+            CHECK(arena.allocate(64u, 8u) != first);
+        }
+        std::pmr::vector<int> vec(&arena);
+        for (int i = 0; i < 200; i++)
+            vec.push_back(i);
+        CHECK(vec.back() == 199);
+    }
+    const auto nb_blocks = arena.nb_blocks();
+    const auto capacity = arena.capacity();
+    CHECK(nb_blocks > 1u);
+
+    // The memory is recycled after the end of a scope
+    for (int iter = 0; iter < 3; iter++)
+    {
+        Arena::Scope scope(arena);
+        CHECK(arena.allocate(64u, 8u) == first);
+        std::pmr::vector<int> vec(&arena);
+        for (int i = 0; i < 200; i++)
+            vec.push_back(i);
+    }
+    CHECK(arena.nb_blocks() == nb_blocks);
+    CHECK(arena.capacity() == capacity);
+}
+
+} // namespace picross
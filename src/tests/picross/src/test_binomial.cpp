@@ -19,8 +19,11 @@ TEST_CASE("overflow", "[binomial]")
     binomial::Cache binomial;
     constexpr auto MAX = binomial::overflowValue();
     CHECK(binomial.partition_n_elts_into_k_buckets(24, 14) == 3562467300u);
-    CHECK(binomial.partition_n_elts_into_k_buckets(23, 15) == MAX);
-    CHECK(binomial.partition_n_elts_into_k_buckets(24, 15) == MAX);
+    CHECK(binomial.partition_n_elts_into_k_buckets(23, 15) == 6107086800u);
+    CHECK(binomial.partition_n_elts_into_k_buckets(24, 15) == 9669554100u);
+    CHECK(binomial.partition_n_elts_into_k_buckets(39, 30) == 13750991318793417920u);
+    CHECK(binomial.partition_n_elts_into_k_buckets(40, 30) == MAX);
+    CHECK(binomial.partition_n_elts_into_k_buckets(39, 31) == MAX);
 }
 
 TEST_CASE("add", "[binomial]")
@@ -45,6 +48,10 @@ TEST_CASE("add", "[binomial]")
         binomial::add(nb_alternatives, binomial.partition_n_elts_into_k_buckets(25, 13));
         CHECK(nb_alternatives == 2u * 1852482996u);
         binomial::add(nb_alternatives, binomial.partition_n_elts_into_k_buckets(25, 13));
+        CHECK(nb_alternatives == 5557448988u);
+        binomial::add(nb_alternatives, binomial.partition_n_elts_into_k_buckets(39, 30));
+        CHECK(nb_alternatives == 13750991324350866908u);
+        binomial::add(nb_alternatives, binomial.partition_n_elts_into_k_buckets(39, 30));
         CHECK(nb_alternatives == MAX);
         binomial::add(nb_alternatives, binomial.partition_n_elts_into_k_buckets(25, 13));
         CHECK(nb_alternatives == MAX);
@@ -64,6 +71,9 @@ TEST_CASE("mult", "[binomial]")
     {
         constexpr auto MAX = binomial::overflowValue();
         binomial::Rep nb_alternatives{1};
+        for (unsigned int count = 0; count < 16; count++)
+             binomial::mult(nb_alternatives, 4);
+        CHECK(nb_alternatives == 4294967296u);
         for (unsigned int count = 0; count < 16; count++)
              binomial::mult(nb_alternatives, 4);
         CHECK(nb_alternatives == MAX);
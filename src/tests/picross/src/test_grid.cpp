@@ -0,0 +1,74 @@
+#include <catch_amalgamated.hpp>
+
+#include "grid.h"
+
+#include <picross/picross.h>
+#include <utils/text_io.h>
+
+
+namespace picross {
+
+namespace {
+    // Copy the tiles of a grid into a fresh one, so that its hash is computed from scratch
+    Grid copy_tile_by_tile(const Grid& grid)
+    {
+        Grid result(grid.width(), grid.height());
+        for (unsigned int y = 0u; y < grid.height(); y++)
+            for (unsigned int x = 0u; x < grid.width(); x++)
+                result.set(x, y, grid.get(x, y));
+        return result;
+    }
+} // namespace
+
+TEST_CASE("grid_hash_is_incremental", "[grid]")
+{
+    Grid grid(4, 3);
+    const auto unknown_hash = grid.hash();
+    CHECK(unknown_hash == Grid(4, 3).hash());
+    CHECK(unknown_hash != Grid(3, 4).hash());
+
+    CHECK(grid.set(1, 2, Tile::FILLED));
+    CHECK(grid.update(3, 0, Tile::EMPTY));
+    CHECK_FALSE(grid.update(3, 0, Tile::UNKNOWN));
+    const auto hash = grid.hash();
+    CHECK(hash != unknown_hash);
+    CHECK(hash == copy_tile_by_tile(grid).hash());
+
+    // The hash does not depend on the order of the updates
+    Grid other(4, 3);
+    other.set(3, 0, Tile::EMPTY);
+    other.set(1, 2, Tile::EMPTY);
+    CHECK(other.hash() != hash);
+    other.set(1, 2, Tile::FILLED);
+    CHECK(other.hash() == hash);
+    CHECK(other == grid);
+
+    // Setting a tile back to unknown cancels its contribution
+    grid.set(1, 2, Tile::UNKNOWN);
+    grid.set(3, 0, Tile::UNKNOWN);
+    CHECK(grid.hash() == unknown_hash);
+
+    grid = other;
+    CHECK(grid.hash() == hash);
+    grid.reset();
+    CHECK(grid.hash() == unknown_hash);
+
+    CHECK(Grid(4, 3, Tile::FILLED).hash() == copy_tile_by_tile(Grid(4, 3, Tile::FILLED)).hash());
+}
+
+TEST_CASE("output_grid_hash", "[grid]")
+{
+    const OutputGrid grid = build_output_grid_from(3, 2, R"(
+        #.#
+        .##
+    )");
+    OutputGrid other(3, 2);
+    CHECK(other.hash() != grid.hash());
+    for (unsigned int y = 0u; y < 2u; y++)
+        for (unsigned int x = 0u; x < 3u; x++)
+            other.set_tile(x, y, grid.get_tile(x, y));
+    CHECK(other.hash() == grid.hash());
+    CHECK(OutputGrid(grid).hash() == grid.hash());
+}
+
+} // namespace picross
@@ -0,0 +1,60 @@
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+
+#include "implication_graph.h"
+
+
+namespace picross {
+
+namespace {
+    ImplicationGraph::Literals implied(const ImplicationGraph& graph, const ImplicationGraph::Literal& premise)
+    {
+        ImplicationGraph::Literals result;
+        graph.for_each_implied(premise, [&result](const ImplicationGraph::Literal& literal) { result.push_back(literal); return true; });
+        return result;
+    }
+} // namespace
+
+TEST_CASE("implication_graph_add", "[implication_graph]")
+{
+    using Literal = ImplicationGraph::Literal;
+    ImplicationGraph graph(5u, 4u, 100u);
+    CHECK(graph.empty());
+    CHECK(implied(graph, Literal{ 2u, 1u, Tile::FILLED }).empty());
+
+    graph.add(Literal{ 2u, 1u, Tile::FILLED }, { Literal{ 4u, 3u, Tile::EMPTY }, Literal{ 0u, 0u, Tile::FILLED } });
+    CHECK(graph.nb_implications() == 4u);
+
+    const auto conclusions = implied(graph, Literal{ 2u, 1u, Tile::FILLED });
+    REQUIRE(conclusions.size() == 2u);
+    CHECK(conclusions[1].m_x == 4u);
+    CHECK(conclusions[1].m_y == 3u);
+    CHECK(conclusions[1].m_tile == Tile::EMPTY);
+    CHECK(implied(graph, Literal{ 2u, 1u, Tile::EMPTY }).empty());
+
+    // Contrapositive
+    const auto contrapositive = implied(graph, Literal{ 4u, 3u, Tile::FILLED });
+    REQUIRE(contrapositive.size() == 1u);
+    CHECK(contrapositive[0].m_x == 2u);
+    CHECK(contrapositive[0].m_y == 1u);
+    CHECK(contrapositive[0].m_tile == Tile::EMPTY);
+
+    // Known implications are not added twice
+    graph.add(Literal{ 2u, 1u, Tile::FILLED }, { Literal{ 4u, 3u, Tile::EMPTY } });
+    CHECK(graph.nb_implications() == 4u);
+    CHECK(implied(graph, Literal{ 2u, 1u, Tile::FILLED }).size() == 2u);
+}
+
+TEST_CASE("implication_graph_is_bounded", "[implication_graph]")
+{
+    using Literal = ImplicationGraph::Literal;
+    ImplicationGraph graph(8u, 8u, 10u);
+    ImplicationGraph::Literals conclusions;
+    for (Line::Index x = 1u; x < 8u; x++)
+        conclusions.push_back(Literal{ x, 0u, Tile::FILLED });
+    graph.add(Literal{ 0u, 0u, Tile::FILLED }, conclusions);
+    CHECK(graph.nb_implications() == 10u);
+    CHECK(implied(graph, Literal{ 0u, 0u, Tile::FILLED }).size() == 5u);
+}
+
+} // namespace picross
@@ -0,0 +1,67 @@
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+
+#include "line_activity.h"
+
+
+namespace picross {
+
+TEST_CASE("line_activity_bump", "[line_activity]")
+{
+    LineActivity activity(3u, 2u);
+    const LineId row(Line::ROW, 1u);
+    const LineId col(Line::COL, 2u);
+    CHECK(activity.activity(row) == 0.0);
+    CHECK(activity.activity(col) == 0.0);
+    CHECK(activity.nb_bumps() == 0u);
+
+    activity.bump(row);
+    CHECK(activity.activity(row) > 0.0);
+    CHECK(activity.activity(col) == 0.0);
+    CHECK(activity.activity(LineId(Line::ROW, 0u)) == 0.0);
+    CHECK(activity.activity(LineId(Line::COL, 1u)) == 0.0);
+
+    // The bumps after a decay weigh more
+    activity.decay();
+    activity.bump(col);
+    CHECK(activity.activity(col) > activity.activity(row));
+    activity.decay();
+    activity.bump(row);
+    CHECK(activity.activity(row) > activity.activity(col));
+    CHECK(activity.nb_bumps() == 3u);
+}
+
+TEST_CASE("line_activity_conflict", "[line_activity]")
+{
+    // The lines bumped by the same contradiction have the same activity
+    LineActivity activity(3u, 2u);
+    const LineId row(Line::ROW, 0u);
+    const LineId col(Line::COL, 1u);
+    activity.bump(row);
+    activity.bump(col);
+    activity.decay();
+    CHECK(activity.activity(row) == activity.activity(col));
+    CHECK(activity.activity(row) > 0.0);
+    CHECK(activity.nb_bumps() == 2u);
+}
+
+TEST_CASE("line_activity_rescale", "[line_activity]")
+{
+    LineActivity activity(2u, 2u);
+    const LineId row(Line::ROW, 0u);
+    const LineId col(Line::COL, 0u);
+    for (unsigned int i = 0u; i < 10000u; i++)
+    {
+        activity.bump(i % 3u == 0u ? col : row);
+        activity.decay();
+    }
+
+    const double row_activity = activity.activity(row);
+    const double col_activity = activity.activity(col);
+    CHECK(row_activity > col_activity);
+    CHECK(col_activity > 0.0);
+    CHECK(row_activity < 1e101);
+    CHECK(activity.nb_bumps() == 10000u);
+}
+
+} // namespace picross
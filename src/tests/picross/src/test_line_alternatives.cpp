@@ -10,7 +10,9 @@
 #include "line_span.h"
 
 #include <algorithm>
+#include <string>
 #include <utility>
+#include <vector>
 
 
 namespace picross {
@@ -477,7 +479,6 @@ TEST_CASE("linear_reduction_non_regression_a", "[line_alternatives]")
 
 TEST_CASE("linear_vs_full_reduction", "[line_alternatives]")
 {
-    constexpr auto MAX = binomial::overflowValue();
     {
         const LineConstraint constraint(Line::COL, { 7, 6, 9, 3, 3, 4, 4 });   // Example from tiger.non
         const auto known_tiles      = build_line_from("..????###?#???##???????######?###?#??????##???##??", Line::COL, 34);
@@ -682,7 +683,7 @@ TEST_CASE("linear_vs_full_reduction", "[line_alternatives]")
         {
             const auto reduction = linear_reduction(constraint, known_tiles);
             CHECK(known_tiles + reduction.reduced_line == known_tiles);
-            CHECK(reduction.nb_alternatives == MAX);
+            CHECK(reduction.nb_alternatives == 63432274896u);
             CHECK(reduction.is_fully_reduced == false);
         }
     }
@@ -699,11 +700,82 @@ TEST_CASE("linear_vs_full_reduction", "[line_alternatives]")
         {
             const auto reduction = linear_reduction(constraint, known_tiles);
             CHECK(known_tiles + reduction.reduced_line == known_tiles);
-            CHECK(reduction.nb_alternatives == MAX);
+            CHECK(reduction.nb_alternatives == 7307872110u);
             CHECK(reduction.is_fully_reduced == false);
         }
     }
 }
 
+TEST_CASE("full_reduction_vs_recursive_reference", "[line_alternatives]")
+{
+    static const std::string TILE_CHARS = "?.#";
+    const auto all_lines_of_size = [](std::size_t line_sz) {
+        std::vector<Line> result;
+        std::string str(line_sz, '?');
+        std::size_t count = 1u;
+        for (std::size_t c = 0u; c < line_sz; c++) { count *= TILE_CHARS.size(); }
+        for (std::size_t n = 0u; n < count; n++)
+        {
+            std::size_t digits = n;
+            for (auto& c : str) { c = TILE_CHARS[digits % TILE_CHARS.size()]; digits /= TILE_CHARS.size(); }
+            result.push_back(build_line_from(str, Line::ROW, LINE_INDEX));
+        }
+        return result;
+    };
+
+    // Exhaustive comparison on short lines
+    for (const auto& segs : std::vector<InputGrid::Constraint>{ { }, { 1 }, { 3 }, { 1, 1 }, { 2, 1 }, { 2, 3 }, { 1, 2, 1 }, { 1, 1, 1 } })
+    {
+        const LineConstraint constraint(Line::ROW, segs);
+        for (std::size_t line_sz = constraint.min_line_size(); line_sz <= 8u; line_sz++)
+        {
+            for (const auto& known_tiles : all_lines_of_size(line_sz))
+            {
+                const auto expected = LineAlternatives(constraint, known_tiles, get_binomial()).full_reduction_recursive();
+                const auto reduction = full_reduction(constraint, known_tiles);
+                CHECK(reduction.nb_alternatives == expected.nb_alternatives);
+                CHECK(reduction.is_fully_reduced == expected.is_fully_reduced);
+                if (expected.nb_alternatives > 0)
+                    CHECK(reduction.reduced_line == expected.reduced_line);
+            }
+        }
+    }
+
+    // Saturated nb of alternatives
+    {
+        const LineConstraint constraint(Line::ROW, InputGrid::Constraint(30, 1));
+        const auto known_tiles = build_line_from(std::string(50, '?') + "#" + std::string(49, '?'), Line::ROW, LINE_INDEX);
+        const auto expected = LineAlternatives(constraint, known_tiles, get_binomial()).full_reduction_recursive();
+        const auto reduction = full_reduction(constraint, known_tiles);
+        CHECK(expected.nb_alternatives == binomial::overflowValue());
+        CHECK(reduction.nb_alternatives == binomial::overflowValue());
+        CHECK(reduction.reduced_line == expected.reduced_line);
+    }
+}
+
+TEST_CASE("full_reduction_after_tiles_update", "[line_alternatives]")
+{
+    // The same LineAlternatives object is reduced after each update of the known tiles, the result must match
+    // the reduction of a new object.
+    const LineConstraint constraint(Line::ROW, { 2, 1, 3, 1 });
+    const std::string solution = "..##.#...###..#...";
+    for (const auto& order : std::vector<std::vector<std::size_t>>{
+            { 8, 3, 12, 16, 7, 10, 1, 14, 5, 0, 17, 2, 9, 4, 11, 6, 13, 15 },
+            { 9, 8, 10, 7, 11, 6, 12, 5, 13, 4, 14, 3, 15, 2, 16, 1, 17, 0 } })
+    {
+        auto known_tiles = build_line_from(std::string(solution.size(), '?'), Line::ROW, LINE_INDEX);
+        const auto solution_line = build_line_from(solution, Line::ROW, LINE_INDEX);
+        LineAlternatives line_alternatives(constraint, known_tiles, get_binomial());
+        for (const auto idx : order)
+        {
+            known_tiles[idx] = solution_line[idx];
+            const auto expected = full_reduction(constraint, known_tiles);
+            const auto reduction = line_alternatives.full_reduction();
+            CHECK(reduction.nb_alternatives == expected.nb_alternatives);
+            CHECK(reduction.reduced_line == expected.reduced_line);
+        }
+        CHECK(line_alternatives.full_reduction().nb_alternatives == 1u);
+    }
+}
 
 } // namespace picross
@@ -0,0 +1,134 @@
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+#include <utils/text_io.h>
+
+#include "binomial.h"
+#include "line.h"
+#include "line_alternatives.h"
+#include "line_automaton.h"
+#include "line_constraint.h"
+#include "line_span.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+namespace picross {
+namespace {
+    inline constexpr unsigned int LINE_INDEX = 0;
+
+    LineAlternatives::Reduction expected_full_reduction(const LineConstraint& constraint, const Line& known_tiles)
+    {
+        static binomial::Cache binomial;
+        return LineAlternatives(constraint, known_tiles, binomial).full_reduction();
+    }
+}
+
+TEST_CASE("line_automaton_states", "[line_automaton]")
+{
+    CHECK(LineAutomaton(LineConstraint(Line::ROW, { })).nb_states() == 1u);
+    CHECK(LineAutomaton(LineConstraint(Line::ROW, { 2, 1, 3 })).nb_states() == 10u);
+    CHECK(LineAutomaton(LineConstraint(Line::ROW, { 2, 1, 3 })).nb_words() == 1u);
+    CHECK(LineAutomaton(LineConstraint(Line::ROW, { 59, 2 })).nb_words() == 1u);
+    CHECK(LineAutomaton(LineConstraint(Line::ROW, { 60, 2 })).nb_words() == 2u);
+}
+
+TEST_CASE("line_automaton_simple_use_cases", "[line_automaton]")
+{
+    LineAutomaton::Buffers buffers;
+    {
+        const LineAutomaton automaton(LineConstraint(Line::ROW, { 3 }));
+        const auto reduction = automaton.full_reduction(build_line_from("?????", Line::ROW, LINE_INDEX), buffers);
+        CHECK(reduction.reduced_line == build_line_from("??#??", Line::ROW, LINE_INDEX));
+        CHECK(reduction.nb_alternatives == 3u);
+        CHECK(reduction.is_fully_reduced);
+    }
+    {
+        const LineAutomaton automaton(LineConstraint(Line::COL, { 1, 2 }));
+        const auto reduction = automaton.full_reduction(build_line_from("?#???.", Line::COL, 4), buffers);
+        CHECK(reduction.reduced_line == build_line_from(".#.##.", Line::COL, 4));
+        CHECK(reduction.nb_alternatives == 1u);
+    }
+    {
+        // Contradictory
+        const LineAutomaton automaton(LineConstraint(Line::ROW, { 1, 1 }));
+        const auto known_tiles = build_line_from("?#?", Line::ROW, LINE_INDEX);
+        const auto reduction = automaton.full_reduction(known_tiles, buffers);
+        CHECK(reduction.reduced_line.type() == known_tiles.type());
+        CHECK(reduction.reduced_line.index() == known_tiles.index());
+        CHECK(reduction.reduced_line.size() == known_tiles.size());
+        CHECK(reduction.nb_alternatives == 0u);
+        CHECK(automaton.full_reduction(known_tiles, buffers, false).nb_alternatives == 0u);
+    }
+    {
+        // Without the count
+        const LineAutomaton automaton(LineConstraint(Line::ROW, { 1 }));
+        const auto reduction = automaton.full_reduction(build_line_from("??.??", Line::ROW, LINE_INDEX), buffers, false);
+        CHECK(reduction.reduced_line == build_line_from("??.??", Line::ROW, LINE_INDEX));
+        CHECK(reduction.nb_alternatives == 1u);
+    }
+}
+
+TEST_CASE("line_automaton_vs_line_alternatives", "[line_automaton]")
+{
+    static const std::string TILE_CHARS = "?.#";
+    LineAutomaton::Buffers buffers;
+
+    // Exhaustive comparison on short lines
+    for (const auto& segs : std::vector<InputGrid::Constraint>{ { }, { 1 }, { 3 }, { 1, 1 }, { 2, 1 }, { 2, 3 }, { 1, 2, 1 }, { 1, 1, 1 } })
+    {
+        const LineConstraint constraint(Line::ROW, segs);
+        const LineAutomaton automaton(constraint);
+        for (std::size_t line_sz = std::max(constraint.min_line_size(), 1u); line_sz <= 8u; line_sz++)
+        {
+            std::string str(line_sz, '?');
+            std::size_t count = 1u;
+            for (std::size_t c = 0u; c < line_sz; c++) { count *= TILE_CHARS.size(); }
+            for (std::size_t n = 0u; n < count; n++)
+            {
+                std::size_t digits = n;
+                for (auto& c : str) { c = TILE_CHARS[digits % TILE_CHARS.size()]; digits /= TILE_CHARS.size(); }
+                const auto known_tiles = build_line_from(str, Line::ROW, LINE_INDEX);
+                const auto expected = expected_full_reduction(constraint, known_tiles);
+                const auto reduction = automaton.full_reduction(known_tiles, buffers);
+                CHECK(reduction.nb_alternatives == expected.nb_alternatives);
+                if (expected.nb_alternatives > 0)
+                    CHECK(reduction.reduced_line == expected.reduced_line);
+            }
+        }
+    }
+
+    // Long lines, where the state of the automaton spans several words
+    for (const auto& segs : std::vector<InputGrid::Constraint>{ { 30, 1, 20, 5, 12 }, { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 } })
+    {
+        const LineConstraint constraint(Line::COL, segs);
+        const LineAutomaton automaton(constraint);
+        CHECK(automaton.nb_words() == 2u);
+        for (const auto& str : {
+                std::string(90, '?'),
+                std::string(20, '?') + "#" + std::string(30, '?') + ".." + std::string(37, '?'),
+                std::string(44, '?') + "#.#" + std::string(43, '?'),
+                "." + std::string(40, '?') + "###.#" + std::string(40, '?') + ".###" })
+        {
+            const auto known_tiles = build_line_from(str, Line::COL, 1);
+            const auto expected = expected_full_reduction(constraint, known_tiles);
+            const auto reduction = automaton.full_reduction(known_tiles, buffers);
+            CHECK(reduction.nb_alternatives == expected.nb_alternatives);
+            if (expected.nb_alternatives > 0)
+                CHECK(reduction.reduced_line == expected.reduced_line);
+        }
+    }
+
+    // Saturated nb of alternatives
+    {
+        const LineConstraint constraint(Line::ROW, InputGrid::Constraint(30, 1));
+        const auto known_tiles = build_line_from(std::string(50, '?') + "#" + std::string(49, '?'), Line::ROW, LINE_INDEX);
+        const auto expected = expected_full_reduction(constraint, known_tiles);
+        const auto reduction = LineAutomaton(constraint).full_reduction(known_tiles, buffers);
+        CHECK(reduction.nb_alternatives == binomial::overflowValue());
+        CHECK(reduction.reduced_line == expected.reduced_line);
+    }
+}
+
+} // namespace picross
@@ -4,6 +4,9 @@
 
 #include "line_constraint.h"
 
+#include <string>
+#include <vector>
+
 
 namespace picross {
 namespace {
@@ -90,4 +93,50 @@ TEST_CASE("trivial_reduction", "[line_constraint]")
     CHECK(constraint.line_trivial_reduction(14, LINE_INDEX) == build_line_from("??????????????", Line::ROW, LINE_INDEX));
 }
 
+TEST_CASE("alternatives_enumerator", "[line_constraint]")
+{
+    const auto all_alternatives = [](const LineConstraint& constraint, const Line& known_tiles) {
+        std::vector<Line> result;
+        AlternativesEnumerator enumerator(constraint, known_tiles);
+        while (enumerator.next()) { result.push_back(enumerator.current()); }
+        CHECK_FALSE(enumerator.next());
+        return result;
+    };
+
+    SECTION("simple use cases")
+    {
+        const LineConstraint constraint(Line::ROW, { 2, 1 });
+        const auto alternatives = all_alternatives(constraint, build_line_from("??.???", Line::ROW, LINE_INDEX));
+        REQUIRE(alternatives.size() == 3u);
+        CHECK(alternatives[0] == build_line_from("##.#..", Line::ROW, LINE_INDEX));
+        CHECK(alternatives[1] == build_line_from("##..#.", Line::ROW, LINE_INDEX));
+        CHECK(alternatives[2] == build_line_from("##...#", Line::ROW, LINE_INDEX));
+        CHECK(all_alternatives(constraint, build_line_from("#?#?#?", Line::ROW, LINE_INDEX)).empty());
+        CHECK(all_alternatives(LineConstraint(Line::ROW, {}), build_line_from("....", Line::ROW, LINE_INDEX)).size() == 1u);
+        CHECK(all_alternatives(LineConstraint(Line::ROW, {}), build_line_from("..#.", Line::ROW, LINE_INDEX)).empty());
+    }
+
+    SECTION("same alternatives as build_all_possible_lines")
+    {
+        static const std::string TILE_CHARS = "?.#";
+        for (const auto& segs : std::vector<InputGrid::Constraint>{ { }, { 1 }, { 3 }, { 1, 1 }, { 2, 1 }, { 1, 2, 1 } })
+        {
+            const LineConstraint constraint(Line::ROW, segs);
+            for (std::size_t line_sz = constraint.min_line_size(); line_sz <= 7u; line_sz++)
+            {
+                std::size_t count = 1u;
+                for (std::size_t c = 0u; c < line_sz; c++) { count *= TILE_CHARS.size(); }
+                std::string str(line_sz, '?');
+                for (std::size_t n = 0u; n < count; n++)
+                {
+                    std::size_t digits = n;
+                    for (auto& c : str) { c = TILE_CHARS[digits % TILE_CHARS.size()]; digits /= TILE_CHARS.size(); }
+                    const auto known_tiles = build_line_from(str, Line::ROW, LINE_INDEX);
+                    CHECK(all_alternatives(constraint, known_tiles) == constraint.build_all_possible_lines(known_tiles));
+                }
+            }
+        }
+    }
+}
+
 } // namespace picross
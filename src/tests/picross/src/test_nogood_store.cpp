@@ -0,0 +1,62 @@
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+#include <utils/text_io.h>
+
+#include "line_span.h"
+#include "nogood_store.h"
+
+
+namespace picross {
+
+namespace {
+    std::size_t nb_nogoods_found(const NogoodStore& store, const LineId& line_id, std::uint64_t hash)
+    {
+        std::size_t count = 0u;
+        store.find(line_id, hash, [&count](const NogoodStore::Decision*, const NogoodStore::Decision*) { count++; return false; });
+        return count;
+    }
+} // namespace
+
+TEST_CASE("nogood_store_add", "[nogood_store]")
+{
+    const Line row = build_line_from("..##.", Line::ROW, 2u);
+    const Line col = build_line_from("#..", Line::COL, 4u);
+    const Line other_row = build_line_from("...##", Line::ROW, 2u);
+    const auto row_hash = NogoodStore::line_hash(LineSpan(row));
+    const auto col_hash = NogoodStore::line_hash(LineSpan(col));
+    CHECK(row_hash != NogoodStore::line_hash(LineSpan(other_row)));
+
+    NogoodStore store(100u);
+    CHECK(store.nb_nogoods() == 0u);
+    CHECK(nb_nogoods_found(store, LineId(row), row_hash) == 0u);
+
+    CHECK(store.add({ NogoodStore::Decision{ LineId(row), row_hash }, NogoodStore::Decision{ LineId(col), col_hash } }));
+    CHECK(store.nb_nogoods() == 1u);
+    CHECK(nb_nogoods_found(store, LineId(row), row_hash) == 1u);
+    CHECK(nb_nogoods_found(store, LineId(col), col_hash) == 1u);
+    CHECK(nb_nogoods_found(store, LineId(row), col_hash) == 0u);
+    CHECK(nb_nogoods_found(store, LineId(Line::ROW, 1u), row_hash) == 0u);
+    CHECK(nb_nogoods_found(store, LineId(Line::COL, 2u), row_hash) == 0u);
+
+    std::size_t nb_decisions = 0u;
+    CHECK(store.find(LineId(col), col_hash, [&nb_decisions](const NogoodStore::Decision* begin, const NogoodStore::Decision* end) {
+        nb_decisions = static_cast<std::size_t>(end - begin);
+        return true;
+    }));
+    CHECK(nb_decisions == 2u);
+}
+
+TEST_CASE("nogood_store_is_bounded", "[nogood_store]")
+{
+    const Line row = build_line_from("#.#", Line::ROW, 0u);
+    const auto hash = NogoodStore::line_hash(LineSpan(row));
+    NogoodStore store(5u);
+    const NogoodStore::Decisions nogood = { NogoodStore::Decision{ LineId(row), hash }, NogoodStore::Decision{ LineId(Line::COL, 1u), hash } };
+    CHECK(store.add(nogood));
+    CHECK(store.add(nogood));
+    CHECK_FALSE(store.add(nogood));
+    CHECK_FALSE(store.add({}));
+    CHECK(store.nb_nogoods() == 2u);
+}
+
+} // namespace picross
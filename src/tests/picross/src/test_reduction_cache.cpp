@@ -0,0 +1,56 @@
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+#include <utils/text_io.h>
+
+#include "line.h"
+#include "line_span.h"
+#include "reduction_cache.h"
+
+
+namespace picross {
+
+TEST_CASE("reduction_cache_read_and_store", "[reduction_cache]")
+{
+    ReductionCache cache(12u, 16u);
+    CHECK(cache.nb_entries() == 16u);
+
+    const auto known_tiles = build_line_from("??#?????..??", Line::ROW, 3);
+    const auto reduced_line = build_line_from("?##?????..?.", Line::ROW, 3);
+    CHECK_FALSE(cache.read_line(known_tiles));
+
+    cache.store_line(known_tiles, reduced_line, 7u);
+    const auto entry = cache.read_line(known_tiles);
+    REQUIRE(entry);
+    CHECK(entry->m_reduced_line == LineSpan(reduced_line));
+    CHECK(entry->m_nb_alt == 7u);
+
+    // Different known tiles, or a different line (that is, a different constraint)
+    CHECK_FALSE(cache.read_line(build_line_from("??#?????.???", Line::ROW, 3)));
+    CHECK_FALSE(cache.read_line(build_line_from("??#?????..??", Line::ROW, 4)));
+    CHECK_FALSE(cache.read_line(build_line_from("??#?????..??", Line::COL, 3)));
+}
+
+TEST_CASE("reduction_cache_is_bounded", "[reduction_cache]")
+{
+    ReductionCache cache(4u, 4u);
+    const auto line = [](unsigned int idx) { return build_line_from("?#??", Line::COL, idx); };
+    for (unsigned int idx = 0u; idx < 64u; idx++)
+    {
+        cache.store_line(line(idx), line(idx), idx + 1u);
+        const auto entry = cache.read_line(line(idx));
+        REQUIRE(entry);
+        CHECK(entry->m_nb_alt == idx + 1u);
+    }
+    unsigned int nb_hits = 0u;
+    for (unsigned int idx = 0u; idx < 64u; idx++)
+    {
+        if (const auto entry = cache.read_line(line(idx)))
+        {
+            CHECK(entry->m_nb_alt == idx + 1u);
+            nb_hits++;
+        }
+    }
+    CHECK(nb_hits <= cache.nb_entries());
+}
+
+} // namespace picross
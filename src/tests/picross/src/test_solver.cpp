@@ -3,6 +3,10 @@
 #include <utils/test_helpers.h>
 #include <utils/text_io.h>
 
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 
 namespace picross {
 
@@ -450,4 +454,183 @@ TEST_CASE("Puzzle: 3-DOM", "[solver]")
     CHECK(validation_result.difficulty_code == 2);  // BRANCH
 }
 
+TEST_CASE("Backjumping does not change the solutions", "[solver]")
+{
+    // 5-DOM: the smallest domino pattern on which the sequential branch search learns nogoods
+    OutputGrid expected = build_output_grid_from(11, 11, R"(
+        ........###
+        ..........#
+        ......###.#
+        ........#..
+        ....###.#..
+        ......#....
+        ..###.#....
+        ....#......
+        ###.#......
+        ..#........
+        ..#........
+    )", "5-DOM");
+
+    InputGrid puzzle = get_input_grid_from(expected);
+
+    SolverConfig config;
+    config.nb_threads = 1u;
+
+    const auto solve = [&puzzle](const SolverConfig& config, GridStats& stats) {
+        const auto solver = get_ref_solver(config);
+        solver->set_stats(stats);
+        const auto result = solver->solve(puzzle);
+        CHECK(result.status == Solver::Status::OK);
+        OutputGridSet solution_grids;
+        for (const auto& solution : result.solutions)
+            solution_grids.insert(solution.grid);
+        return solution_grids;
+    };
+
+    config.backjumping = true;
+    GridStats backjumping_stats;
+    const auto backjumping_solutions = solve(config, backjumping_stats);
+
+    config.backjumping = false;
+    GridStats no_backjumping_stats;
+    const auto no_backjumping_solutions = solve(config, no_backjumping_stats);
+
+    CHECK(backjumping_solutions == OutputGridSet { expected });
+    CHECK(backjumping_solutions == no_backjumping_solutions);
+    CHECK(backjumping_stats.nb_backjumps + backjumping_stats.nb_nogoods > 0u);
+    CHECK(no_backjumping_stats.nb_backjumps == 0u);
+    CHECK(no_backjumping_stats.nb_nogoods == 0u);
+}
+
+TEST_CASE("All the line solver engines give the same solutions", "[solver]")
+{
+    std::vector<InputGrid> puzzles;
+
+    // 5-DOM: branching and nogoods
+    puzzles.push_back(get_input_grid_from(build_output_grid_from(11, 11, R"(
+        ........###
+        ..........#
+        ......###.#
+        ........#..
+        ....###.#..
+        ......#....
+        ..###.#....
+        ....#......
+        ###.#......
+        ..#........
+        ..#........
+    )", "5-DOM")));
+
+    // Notes: two solutions
+    puzzles.push_back(get_input_grid_from(build_output_grid_from(10, 10, R"(
+        ..###.....
+        ..#.#.....
+        ..#.#.....
+        ###.......
+        ###.......
+        .......###
+        .......#.#
+        .......#.#
+        .....###..
+        .....###..
+    )", "Notes")));
+
+    // Wide: the automaton of the rows does not fit in one machine word, AUTO falls back to the dynamic programming
+    const std::size_t wide_width = 80;
+    std::string wide_tiles;
+    wide_tiles += std::string(wide_width, '#') + '\n';
+    for (std::size_t x = 0; x < wide_width; x++) { wide_tiles += (x % 2 == 0) ? '#' : '.'; }
+    wide_tiles += '\n';
+    for (std::size_t x = 0; x < wide_width; x++) { wide_tiles += (x % 3 == 1) ? '.' : '#'; }
+    wide_tiles += '\n';
+    wide_tiles += '.' + std::string(wide_width - 1, '#') + '\n';
+    puzzles.push_back(get_input_grid_from(build_output_grid_from(wide_width, 4, wide_tiles, "Wide")));
+
+    const auto solve = [](const InputGrid& puzzle, LineSolverEngine engine) {
+        SolverConfig config;
+        config.nb_threads = 1u;
+        config.line_solver_engine = engine;
+        const auto solver = get_ref_solver(config);
+        const auto result = solver->solve(puzzle);
+        CHECK(result.status == Solver::Status::OK);
+        OutputGridSet solution_grids;
+        for (const auto& solution : result.solutions)
+            solution_grids.insert(solution.grid);
+        return solution_grids;
+    };
+
+    for (const auto& puzzle : puzzles)
+    {
+        INFO("Puzzle: " << puzzle.name());
+        const auto reference_solutions = solve(puzzle, LineSolverEngine::LINE_ALTERNATIVES);
+        CHECK_FALSE(reference_solutions.empty());
+        CHECK(solve(puzzle, LineSolverEngine::AUTOMATON) == reference_solutions);
+        CHECK(solve(puzzle, LineSolverEngine::AUTO) == reference_solutions);
+    }
+}
+
+TEST_CASE("Solver configuration", "[solver]")
+{
+    SolverConfig config;
+    CHECK(check_solver_config(config).first);
+    CHECK(get_ref_solver(config));
+
+    SECTION("Invalid configurations")
+    {
+        SolverConfig invalid_config = config;
+        SECTION("min_nb_alternatives") { invalid_config.min_nb_alternatives = 0u; }
+        SECTION("max_nb_alternatives") { invalid_config.max_nb_alternatives = invalid_config.min_nb_alternatives - 1u; }
+        SECTION("max_nb_alternatives overflow") { invalid_config.max_nb_alternatives = SolverConfig::MAX_NB_ALTERNATIVES + 1u; }
+        SECTION("nb_threads") { invalid_config.nb_threads = SolverConfig::MAX_NB_THREADS + 1u; }
+        SECTION("line_solver_engine") { invalid_config.line_solver_engine = static_cast<LineSolverEngine>(3); }
+        SECTION("nb_lines_per_probing_round") { invalid_config.nb_lines_per_probing_round = 0u; }
+        SECTION("nb_cells_per_probing_round") { invalid_config.nb_cells_per_probing_round = 0u; }
+
+        const auto [is_valid, msg] = check_solver_config(invalid_config);
+        CHECK_FALSE(is_valid);
+        CHECK_FALSE(msg.empty());
+        CHECK_THROWS_AS(get_ref_solver(invalid_config), std::invalid_argument);
+    }
+
+    SECTION("Sequential solver without probing")
+    {
+        OutputGrid expected = build_output_grid_from(7, 7, R"(
+            ....###
+            ......#
+            ..###.#
+            ....#..
+            ###.#..
+            ..#....
+            ..#....
+        )", "3-DOM");
+
+        InputGrid puzzle = get_input_grid_from(expected);
+
+        config.probing = false;
+        config.line_cache = false;
+        config.backjumping = false;
+        config.nb_threads = 1u;
+        config.nb_lines_per_probing_round = 0u;     // Ignored if probing is disabled
+        SECTION("Fewest alternatives") { config.branching_heuristic = BranchingHeuristic::FEWEST_ALTERNATIVES; }
+        SECTION("Next to completed") { config.branching_heuristic = BranchingHeuristic::NEXT_TO_COMPLETED; }
+        SECTION("Activity") { config.branching_heuristic = BranchingHeuristic::ACTIVITY; }
+        REQUIRE(check_solver_config(config).first);
+
+        const auto solver = get_ref_solver(config);
+        REQUIRE(solver);
+        GridStats stats;
+        solver->set_stats(stats);
+        const auto result = solver->solve(puzzle);
+
+        CHECK(result.status == Solver::Status::OK);
+        REQUIRE(result.solutions.size() == 1);
+        CHECK(result.solutions.front().grid == expected);
+        CHECK(stats.nb_branching_calls > 0u);
+        if (config.branching_heuristic == BranchingHeuristic::FEWEST_ALTERNATIVES)
+            CHECK(stats.nb_branching_heuristic_choices == 0u);
+        if (config.branching_heuristic != BranchingHeuristic::ACTIVITY)
+            CHECK(stats.nb_line_activity_bumps == 0u);
+    }
+}
+
 } // namespace picross
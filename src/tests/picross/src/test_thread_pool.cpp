@@ -0,0 +1,80 @@
+#include <catch_amalgamated.hpp>
+
+#include "thread_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+
+namespace picross {
+
+TEST_CASE("thread_pool_parallel_for", "[thread_pool]")
+{
+    ThreadPool thread_pool(4u);
+    CHECK(thread_pool.nb_threads() == 4u);
+
+    std::vector<unsigned int> values(1000u, 0u);
+    std::atomic<bool> valid_thread_idx = true;
+    std::atomic<bool> running = true;
+    auto f = [&thread_pool, &values, &valid_thread_idx, &running](std::size_t idx, unsigned int thread_idx) {
+        values[idx] += static_cast<unsigned int>(idx);
+        if (thread_idx >= 4u)
+            valid_thread_idx = false;
+        if (!thread_pool.is_running())
+            running = false;
+    };
+
+    // The pool is reused from one loop to the next
+    for (int iter = 0; iter < 3; iter++)
+        thread_pool.parallel_for(values.size(), f);
+    CHECK(valid_thread_idx);
+    CHECK(running);
+    CHECK(!thread_pool.is_running());
+    for (std::size_t idx = 0u; idx < values.size(); idx++)
+        CHECK(values[idx] == 3u * static_cast<unsigned int>(idx));
+
+    std::size_t nb_calls = 0u;
+    auto g = [&nb_calls](std::size_t, unsigned int) { nb_calls++; };
+    thread_pool.parallel_for(0u, g);
+    CHECK(nb_calls == 0u);
+    thread_pool.parallel_for(1u, g);
+    CHECK(nb_calls == 1u);
+}
+
+TEST_CASE("thread_pool_single_thread", "[thread_pool]")
+{
+    ThreadPool thread_pool(1u);
+    CHECK(thread_pool.nb_threads() == 1u);
+
+    std::vector<std::size_t> order;
+    auto f = [&order](std::size_t idx, unsigned int thread_idx) {
+        CHECK(thread_idx == 0u);
+        order.push_back(idx);
+    };
+    thread_pool.parallel_for(5u, f);
+    const std::vector<std::size_t> expected_order = { 0u, 1u, 2u, 3u, 4u };
+    CHECK(order == expected_order);
+}
+
+TEST_CASE("thread_pool_exception", "[thread_pool]")
+{
+    ThreadPool thread_pool(3u);
+    std::atomic<unsigned int> nb_calls = 0u;
+    auto f = [&nb_calls](std::size_t idx, unsigned int) {
+        nb_calls++;
+        if (idx == 10u)
+            throw std::runtime_error("Iteration 10");
+    };
+    CHECK_THROWS_AS(thread_pool.parallel_for(100u, f), std::runtime_error);
+    CHECK(nb_calls == 100u);
+
+    // The pool is still usable after an exception
+    nb_calls = 0u;
+    auto g = [&nb_calls](std::size_t, unsigned int) { nb_calls++; };
+    thread_pool.parallel_for(100u, g);
+    CHECK(nb_calls == 100u);
+}
+
+} // namespace picross
@@ -0,0 +1,78 @@
+#include <catch_amalgamated.hpp>
+#include <picross/picross.h>
+#include <utils/text_io.h>
+
+#include "line.h"
+#include "line_span.h"
+#include "tile_bits.h"
+
+#include <string>
+
+
+namespace picross {
+namespace {
+    inline constexpr unsigned int LINE_INDEX = 0;
+
+    Line build_line(const std::string& str)
+    {
+        return build_line_from(str, Line::ROW, LINE_INDEX);
+    }
+}
+
+TEST_CASE("tile_bits_are_compatible", "[tile_bits]")
+{
+    // Lines longer than 8 tiles are checked with full words, plus a remainder
+    CHECK(are_compatible(build_line("????????????"), build_line("#.#.#.#.#.#.")));
+    CHECK(are_compatible(build_line("##..??##..??"), build_line("##????##..#.")));
+    CHECK_FALSE(are_compatible(build_line("##..??##..??"), build_line("##????#...??")));
+    CHECK_FALSE(are_compatible(build_line("##..??##..??"), build_line("##..??##.#??")));
+    CHECK_FALSE(are_compatible(build_line("#"), build_line(".")));
+}
+
+TEST_CASE("tile_bits_line_operations", "[tile_bits]")
+{
+    const auto line1 = build_line("....##??????.#?");
+    const auto line2 = build_line("..????##..????#");
+    CHECK(line1 + line2 == build_line("....####..??.##"));
+    CHECK(build_line("....####..??.##") - line2 == build_line("??..##??????.#?"));
+
+    Line reduced = build_line("??..######...#?");
+    LineSpanW reduced_span(reduced);
+    line_reduce(reduced_span, build_line("??....######.#?"));
+    CHECK(reduced == build_line("??..??####??.#?"));
+}
+
+TEST_CASE("tile_bits_is_completed", "[tile_bits]")
+{
+    CHECK(LineSpan(build_line("")).is_completed());
+    CHECK(LineSpan(build_line("##..##..##..")).is_completed());
+    CHECK_FALSE(LineSpan(build_line("##..##?.##..")).is_completed());
+    CHECK_FALSE(LineSpan(build_line("##..##..##.?")).is_completed());
+
+    const auto line = build_line("##..##?.##.?#");
+    CHECK(tile_bits::nb_unknown(line.tiles(), line.size()) == 2);
+}
+
+TEST_CASE("bit_planes", "[tile_bits]")
+{
+    const auto line1 = build_line(std::string(60, '#') + "..??" + std::string(6, '.') + "?#");
+    const auto line2 = build_line(std::string(60, '#') + ".#??" + std::string(6, '#') + "?#");
+
+    BitPlanes planes(line1.tiles(), line1.size());
+    CHECK(planes.size() == 72);
+    CHECK(planes.nb_filled() == 61);
+    CHECK(planes.nb_empty() == 8);
+    CHECK_FALSE(planes.is_completed());
+    CHECK(planes == BitPlanes(line1.tiles(), line1.size()));
+    CHECK(planes != BitPlanes(line2.tiles(), line2.size()));
+
+    planes.reduce(line2.tiles(), line2.size());
+    Line reduced(Line::ROW, LINE_INDEX, line1.size());
+    planes.copy_to(reduced.tiles(), 0, reduced.size());
+    CHECK(reduced == build_line(std::string(60, '#') + ".???" + std::string(6, '?') + "?#"));
+    CHECK(planes.get(60) == Tile::EMPTY);
+    CHECK(planes.get(61) == Tile::UNKNOWN);
+    CHECK(planes.get(71) == Tile::FILLED);
+}
+
+} // namespace picross